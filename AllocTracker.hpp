@@ -0,0 +1,221 @@
+#ifndef ALLOC_TRACKER_HPP
+#define ALLOC_TRACKER_HPP
+
+// Opt-in allocation accounting.
+//
+// Compiling with -DPEST_CONTROL_TRACK_ALLOCS replaces the global operator new
+// and delete with versions that prefix every block with a small header naming
+// the account that allocated it. ALLOC_SCOPE("label") charges everything
+// allocated on the current thread until the end of the scope to that label;
+// frees are always charged back to the allocating account, wherever they
+// happen. ALLOC_REPORT(out) writes allocation count, bytes, and current and
+// peak live bytes per account as JSON.
+//
+// Accounts are per label, not per object: every scope using the same label,
+// on any thread, adds to the same numbers, so the three impact trees only
+// show up separately because they are built under different labels, and the
+// per-thread containers of a batch run share one account. There are at most
+// MAX_ACCOUNTS labels; allocations under any label past that only count
+// towards the total.
+//
+// The hooks are also installed for -DPEST_CONTROL_STATS, which only reads the
+// overall totals. Either way this header defines the global operators, so it
+// must only be included from one translation unit.
+
+#if defined(PEST_CONTROL_TRACK_ALLOCS) || defined(PEST_CONTROL_STATS)
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <ostream>
+
+namespace AllocTracker
+{
+    static size_t const MAX_ACCOUNTS = 64;
+
+    // Running totals for one label
+    struct Account
+    {
+        char const *label;
+        std::atomic<uint64_t> allocations;
+        std::atomic<uint64_t> bytes;
+        std::atomic<uint64_t> liveBytes;
+        std::atomic<uint64_t> peakLiveBytes;
+    };
+
+    // Prefix written in front of every tracked block.
+    // Two words keep the returned memory 16 byte aligned.
+    struct Header
+    {
+        Account *account;
+        size_t size;
+    };
+
+    // Accounts live for the whole program so late frees never see a dead account
+    inline Account total{ "total", {0}, {0}, {0}, {0} };
+    inline Account accounts[MAX_ACCOUNTS];
+    inline std::atomic<size_t> accountCount(0);
+    inline std::mutex accountMutex;
+    inline thread_local Account *currentAccount = nullptr;
+
+    // Return the account for label, creating it on first use.
+    // Return nullptr once every slot is taken, so the allocations only count towards the total.
+    inline Account *account(char const *label)
+    {
+        std::lock_guard<std::mutex> lock(accountMutex);
+
+        size_t count = accountCount.load();
+        for (size_t i(0); i < count; ++i)
+        {
+            if (std::strcmp(accounts[i].label, label) == 0)
+            {
+                return &accounts[i];
+            }
+        }
+
+        if (count == MAX_ACCOUNTS)
+        {
+            return nullptr;
+        }
+
+        accounts[count].label = label;
+        accountCount.store(count + 1);
+        return &accounts[count];
+    }
+
+    inline void charge(Account &account, size_t size)
+    {
+        account.allocations.fetch_add(1, std::memory_order_relaxed);
+        account.bytes.fetch_add(size, std::memory_order_relaxed);
+        uint64_t live = account.liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        uint64_t peak = account.peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !account.peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    inline void refund(Account &account, size_t size)
+    {
+        account.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    }
+
+    // Charge this thread's allocations to an account until the scope ends
+    class Scope
+    {
+        private:
+        Account *previous_;
+
+        public:
+
+        Scope(Account *account) : previous_(currentAccount)
+        {
+            currentAccount = account;
+        }
+
+        ~Scope()
+        {
+            currentAccount = previous_;
+        }
+
+        Scope(Scope const &) = delete;
+        Scope &operator =(Scope const &) = delete;
+    };
+
+    inline void writeAccount(std::ostream &out, Account const &account)
+    {
+        out<<"\""<<account.label<<"\":{\"allocations\":"<<account.allocations.load()
+           <<",\"bytes\":"<<account.bytes.load()<<",\"live_bytes\":"<<account.liveBytes.load()
+           <<",\"peak_live_bytes\":"<<account.peakLiveBytes.load()<<"}";
+    }
+
+    // Write the total and every labelled account as one JSON object
+    inline void writeJson(std::ostream &out)
+    {
+        out<<"{\"allocations\":{";
+        writeAccount(out, total);
+        size_t count = accountCount.load();
+        for (size_t i(0); i < count; ++i)
+        {
+            out<<",";
+            writeAccount(out, accounts[i]);
+        }
+        out<<"}}"<<std::endl;
+    }
+}
+
+// GCC flags malloc/free inside replaced operators as mismatched once they are inlined
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void* operator new(std::size_t size)
+{
+    void *block = std::malloc(sizeof(AllocTracker::Header) + size);
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    AllocTracker::Header *header = static_cast<AllocTracker::Header*>(block);
+    header->account = AllocTracker::currentAccount;
+    header->size = size;
+
+    AllocTracker::charge(AllocTracker::total, size);
+    if (header->account != nullptr)
+    {
+        AllocTracker::charge(*header->account, size);
+    }
+
+    return header + 1;
+}
+
+void operator delete(void* memory) noexcept
+{
+    if (memory == nullptr)
+    {
+        return;
+    }
+
+    AllocTracker::Header *header = static_cast<AllocTracker::Header*>(memory) - 1;
+    AllocTracker::refund(AllocTracker::total, header->size);
+    if (header->account != nullptr)
+    {
+        AllocTracker::refund(*header->account, header->size);
+    }
+
+    std::free(header);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    operator delete(memory);
+}
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
+
+
+#ifdef PEST_CONTROL_TRACK_ALLOCS
+
+#define ALLOC_CONCAT_(a, b) a##b
+#define ALLOC_CONCAT(a, b) ALLOC_CONCAT_(a, b)
+#define ALLOC_SCOPE(label) \
+    static AllocTracker::Account * const ALLOC_CONCAT(allocAccount, __LINE__) = AllocTracker::account(label); \
+    AllocTracker::Scope ALLOC_CONCAT(allocScope, __LINE__)(ALLOC_CONCAT(allocAccount, __LINE__))
+#define ALLOC_REPORT(out) AllocTracker::writeJson(out)
+
+#else
+
+#define ALLOC_SCOPE(label)
+#define ALLOC_REPORT(out)
+
+#endif
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef ASSIGNMENT_POLICY_HPP
+#define ASSIGNMENT_POLICY_HPP
+
+#include <algorithm>
+#include <climits>
+#include "Bug.hpp"
+
+
+// How many bugs one developer takes: up to perImpact[i] of each impact
+// level, high impact first, and no more than capacity in total
+struct DeveloperQuota
+{
+    unsigned perImpact[IMPACT_COUNT];
+    unsigned capacity;
+};
+
+// Parse a "high,medium,low" list of per-impact counts, such as "2,1,1".
+// Every count must be plain digits no larger than UINT_MAX.
+// Return false if text isn't in that form.
+inline bool parseImpactCounts(char const *text, unsigned (&counts)[IMPACT_COUNT])
+{
+    unsigned parsed[IMPACT_COUNT];
+    for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+    {
+        if (*text < '0' || *text > '9')
+        {
+            return false;
+        }
+
+        unsigned long long value(0);
+        for (; *text >= '0' && *text <= '9'; ++text)
+        {
+            value = value * 10 + static_cast<unsigned>(*text - '0');
+            if (value > UINT_MAX)
+            {
+                return false;
+            }
+        }
+        parsed[impact] = static_cast<unsigned>(value);
+
+        if (*text != (impact + 1 < IMPACT_COUNT ? ',' : '\0'))
+        {
+            return false;
+        }
+        ++text;
+    }
+
+    std::copy(parsed, parsed + IMPACT_COUNT, counts);
+    return true;
+}
+
+// Parse the per-impact counts of a quota, leaving its capacity alone
+inline bool parseQuota(char const *text, DeveloperQuota &quota)
+{
+    return parseImpactCounts(text, quota.perImpact);
+}
+
+
+// Decides how many bugs each developer gets. The report asks once per
+// developer, in order, so a policy costs O(1) per developer.
+class AssignmentPolicy
+{
+    public:
+
+    virtual ~AssignmentPolicy(){}
+
+    // Return the quota of a developer, numbered from 1
+    virtual DeveloperQuota quota(int developer) const = 0;
+};
+
+// Every developer gets the same quota. The default is the original rule:
+// one bug of each impact level per developer.
+class UniformPolicy : public AssignmentPolicy
+{
+    private:
+    DeveloperQuota quota_;
+
+    public:
+
+    UniformPolicy() : quota_{ { 1, 1, 1 }, UINT_MAX }{}
+
+    explicit UniformPolicy(DeveloperQuota quota) : quota_(quota){}
+
+    DeveloperQuota quota(int) const override
+    {
+        return quota_;
+    }
+};
+
+// The first seniorCount developers get the senior quota (such as two high
+// impact bugs each), everyone after them the regular one
+class SeniorityPolicy : public AssignmentPolicy
+{
+    private:
+    int seniorCount_;
+    DeveloperQuota senior_;
+    DeveloperQuota regular_;
+
+    public:
+
+    SeniorityPolicy(int seniorCount, DeveloperQuota senior, DeveloperQuota regular)
+        : seniorCount_(seniorCount), senior_(senior), regular_(regular){}
+
+    DeveloperQuota quota(int developer) const override
+    {
+        return developer <= seniorCount_ ? senior_ : regular_;
+    }
+};
+
+#endif
@@ -0,0 +1,837 @@
+#ifndef B_TREE_HPP
+#define B_TREE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "LinkedList.hpp"
+#include "FrozenTree.hpp"
+#include "SortKey.hpp"
+
+
+// Ordered container with the same interface as BinarySearchTree, built as a
+// B+ tree. Nodes keep up to CAPACITY compact keys inline in arrays, the
+// elements themselves live out of line in pooled slots, and the leaves are
+// linked so in-order scans walk them linearly. Every node but the root stays
+// at least half full: removals borrow from a sibling or merge with one, so
+// delete-heavy workloads keep the tree as shallow as inserts left it.
+// As with BinarySearchTree, elements with equal keys are only stored once.
+template <typename T, size_t CAPACITY = 32>
+class BTree
+{
+    private:
+
+    static_assert(CAPACITY >= 4, "BTree nodes need room for at least 4 keys");
+
+    typedef typename SortKey<T>::type Key;
+
+    struct Node
+    {
+        bool leaf;
+        size_t count;
+        Key keys[CAPACITY];
+
+        Node(bool l) : leaf(l), count(0){}
+    };
+
+    // Leaves hold the keys and element pointers; separator keys in
+    // inner nodes only route searches
+    struct Leaf : Node
+    {
+        T* data[CAPACITY];
+        Leaf* prev;
+        Leaf* next;
+
+        Leaf() : Node(true), prev(nullptr), next(nullptr){}
+    };
+
+    // children[i] holds keys below keys[i], children[i+1] keys from keys[i] up
+    struct Inner : Node
+    {
+        Node* children[CAPACITY + 1];
+
+        Inner() : Node(false){}
+    };
+
+    // Element storage: blocks of slots, with removed slots reused first
+    union Slot
+    {
+        Slot* nextFree;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static size_t const SLOTS_PER_BLOCK = 256;
+
+    // Fewest keys a node other than the root may hold, as left by a split
+    static size_t const MIN_KEYS = CAPACITY / 2;
+
+    Node* root_;
+    Leaf* head_;
+    Leaf* tail_;
+    size_t count_;
+    std::vector<Slot*> blocks_;
+    Slot* freeSlots_;
+    size_t blockUsed_;
+
+
+    // Copy data into a pooled slot
+    T* allocate(T const &data)
+    {
+        Slot* slot;
+        if (freeSlots_ != nullptr)
+        {
+            slot = freeSlots_;
+            freeSlots_ = slot->nextFree;
+        }
+        else
+        {
+            if (blocks_.empty() || blockUsed_ == SLOTS_PER_BLOCK)
+            {
+                blocks_.push_back(new Slot[SLOTS_PER_BLOCK]);
+                blockUsed_ = 0;
+            }
+            slot = &blocks_.back()[blockUsed_++];
+        }
+
+        return new (slot->storage) T(data);
+    }
+
+    // Destroy an element and return its slot to the pool
+    void release(T* data)
+    {
+        data->~T();
+        Slot* slot = reinterpret_cast<Slot*>(data);
+        slot->nextFree = freeSlots_;
+        freeSlots_ = slot;
+    }
+
+    // Return the index of the first key in node that isn't below key
+    static size_t lowerBound(Node const *node, Key const &key)
+    {
+        return std::lower_bound(node->keys, node->keys + node->count, key) - node->keys;
+    }
+
+    // Return the index of the child of inner that may contain key
+    static size_t childIndex(Inner const *inner, Key const &key)
+    {
+        return std::upper_bound(inner->keys, inner->keys + inner->count, key) - inner->keys;
+    }
+
+
+    // Recursively insert data below node. If node had to split, splitNode is
+    // set to its new right sibling and splitKey to the sibling's lowest key.
+    // Return false if data's key already exists in tree, otherwise true
+    bool insert(Node* node, Key const &key, T const &data, Key &splitKey, Node* &splitNode)
+    {
+        splitNode = nullptr;
+
+        if (node->leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t pos = lowerBound(leaf, key);
+            if (pos < leaf->count && !(key < leaf->keys[pos]))
+            {
+                return false;
+            }
+
+            if (leaf->count == CAPACITY)
+            {
+                // Move the upper half into a new right sibling
+                Leaf* right = new Leaf();
+                size_t half = CAPACITY / 2;
+                std::copy(leaf->keys + half, leaf->keys + CAPACITY, right->keys);
+                std::copy(leaf->data + half, leaf->data + CAPACITY, right->data);
+                right->count = CAPACITY - half;
+                leaf->count = half;
+
+                right->next = leaf->next;
+                right->prev = leaf;
+                if (right->next != nullptr)
+                {
+                    right->next->prev = right;
+                }
+                else
+                {
+                    tail_ = right;
+                }
+                leaf->next = right;
+
+                splitKey = right->keys[0];
+                splitNode = right;
+
+                if (pos > half)
+                {
+                    leaf = right;
+                    pos -= half;
+                }
+            }
+
+            std::copy_backward(leaf->keys + pos, leaf->keys + leaf->count, leaf->keys + leaf->count + 1);
+            std::copy_backward(leaf->data + pos, leaf->data + leaf->count, leaf->data + leaf->count + 1);
+            leaf->keys[pos] = key;
+            leaf->data[pos] = allocate(data);
+            ++leaf->count;
+
+            // A split can leave the new element first in the right sibling
+            if (splitNode != nullptr)
+            {
+                splitKey = static_cast<Leaf*>(splitNode)->keys[0];
+            }
+
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        size_t index = childIndex(inner, key);
+
+        Key childKey;
+        Node* childSplit;
+        if (!insert(inner->children[index], key, data, childKey, childSplit))
+        {
+            return false;
+        }
+        if (childSplit == nullptr)
+        {
+            return true;
+        }
+
+        if (inner->count < CAPACITY)
+        {
+            std::copy_backward(inner->keys + index, inner->keys + inner->count, inner->keys + inner->count + 1);
+            std::copy_backward(inner->children + index + 1, inner->children + inner->count + 1,
+                               inner->children + inner->count + 2);
+            inner->keys[index] = childKey;
+            inner->children[index + 1] = childSplit;
+            ++inner->count;
+            return true;
+        }
+
+        // Full: lay out all CAPACITY + 1 keys, then push the middle one up
+        Key keys[CAPACITY + 1];
+        Node* children[CAPACITY + 2];
+        std::copy(inner->keys, inner->keys + index, keys);
+        keys[index] = childKey;
+        std::copy(inner->keys + index, inner->keys + CAPACITY, keys + index + 1);
+        std::copy(inner->children, inner->children + index + 1, children);
+        children[index + 1] = childSplit;
+        std::copy(inner->children + index + 1, inner->children + CAPACITY + 1, children + index + 2);
+
+        size_t middle = (CAPACITY + 1) / 2;
+        Inner* right = new Inner();
+
+        inner->count = middle;
+        std::copy(keys, keys + middle, inner->keys);
+        std::copy(children, children + middle + 1, inner->children);
+
+        right->count = CAPACITY - middle;
+        std::copy(keys + middle + 1, keys + CAPACITY + 1, right->keys);
+        std::copy(children + middle + 1, children + CAPACITY + 2, right->children);
+
+        splitKey = keys[middle];
+        splitNode = right;
+        return true;
+    }
+
+
+    // Move the last key of the left sibling of inner's child index to the front of the child
+    void borrowFromLeft(Inner* inner, size_t index)
+    {
+        Node* child = inner->children[index];
+        Node* left = inner->children[index - 1];
+
+        std::copy_backward(child->keys, child->keys + child->count, child->keys + child->count + 1);
+        if (child->leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            Leaf* leftLeaf = static_cast<Leaf*>(left);
+            std::copy_backward(leaf->data, leaf->data + leaf->count, leaf->data + leaf->count + 1);
+            leaf->keys[0] = leftLeaf->keys[leftLeaf->count - 1];
+            leaf->data[0] = leftLeaf->data[leftLeaf->count - 1];
+            inner->keys[index - 1] = leaf->keys[0];
+        }
+        else
+        {
+            // The separator comes down into the child and the left sibling's last key goes up
+            Inner* childInner = static_cast<Inner*>(child);
+            Inner* leftInner = static_cast<Inner*>(left);
+            std::copy_backward(childInner->children, childInner->children + childInner->count + 1,
+                               childInner->children + childInner->count + 2);
+            childInner->keys[0] = inner->keys[index - 1];
+            childInner->children[0] = leftInner->children[leftInner->count];
+            inner->keys[index - 1] = leftInner->keys[leftInner->count - 1];
+        }
+
+        ++child->count;
+        --left->count;
+    }
+
+    // Move the first key of the right sibling of inner's child index to the end of the child
+    void borrowFromRight(Inner* inner, size_t index)
+    {
+        Node* child = inner->children[index];
+        Node* right = inner->children[index + 1];
+
+        if (child->leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(child);
+            Leaf* rightLeaf = static_cast<Leaf*>(right);
+            leaf->keys[leaf->count] = rightLeaf->keys[0];
+            leaf->data[leaf->count] = rightLeaf->data[0];
+            std::copy(rightLeaf->keys + 1, rightLeaf->keys + rightLeaf->count, rightLeaf->keys);
+            std::copy(rightLeaf->data + 1, rightLeaf->data + rightLeaf->count, rightLeaf->data);
+            inner->keys[index] = rightLeaf->keys[0];
+        }
+        else
+        {
+            // The separator comes down into the child and the right sibling's first key goes up
+            Inner* childInner = static_cast<Inner*>(child);
+            Inner* rightInner = static_cast<Inner*>(right);
+            childInner->keys[childInner->count] = inner->keys[index];
+            childInner->children[childInner->count + 1] = rightInner->children[0];
+            inner->keys[index] = rightInner->keys[0];
+            std::copy(rightInner->keys + 1, rightInner->keys + rightInner->count, rightInner->keys);
+            std::copy(rightInner->children + 1, rightInner->children + rightInner->count + 1, rightInner->children);
+        }
+
+        ++child->count;
+        --right->count;
+    }
+
+    // Merge inner's child index + 1 into child index and drop the separator between them
+    void merge(Inner* inner, size_t index)
+    {
+        Node* left = inner->children[index];
+        Node* right = inner->children[index + 1];
+
+        if (left->leaf)
+        {
+            Leaf* leftLeaf = static_cast<Leaf*>(left);
+            Leaf* rightLeaf = static_cast<Leaf*>(right);
+            std::copy(rightLeaf->keys, rightLeaf->keys + rightLeaf->count, leftLeaf->keys + leftLeaf->count);
+            std::copy(rightLeaf->data, rightLeaf->data + rightLeaf->count, leftLeaf->data + leftLeaf->count);
+            leftLeaf->count += rightLeaf->count;
+
+            leftLeaf->next = rightLeaf->next;
+            (rightLeaf->next != nullptr ? rightLeaf->next->prev : tail_) = leftLeaf;
+        }
+        else
+        {
+            Inner* leftInner = static_cast<Inner*>(left);
+            Inner* rightInner = static_cast<Inner*>(right);
+            leftInner->keys[leftInner->count] = inner->keys[index];
+            std::copy(rightInner->keys, rightInner->keys + rightInner->count, leftInner->keys + leftInner->count + 1);
+            std::copy(rightInner->children, rightInner->children + rightInner->count + 1,
+                      leftInner->children + leftInner->count + 1);
+            leftInner->count += rightInner->count + 1;
+        }
+
+        deleteNode(right);
+        std::copy(inner->keys + index + 1, inner->keys + inner->count, inner->keys + index);
+        std::copy(inner->children + index + 2, inner->children + inner->count + 1, inner->children + index + 1);
+        --inner->count;
+    }
+
+    // Refill inner's child index after it dropped below MIN_KEYS, from a
+    // sibling that can spare a key, or else by merging it with one
+    void rebalance(Inner* inner, size_t index)
+    {
+        if (index > 0 && inner->children[index - 1]->count > MIN_KEYS)
+        {
+            borrowFromLeft(inner, index);
+        }
+        else if (index < inner->count && inner->children[index + 1]->count > MIN_KEYS)
+        {
+            borrowFromRight(inner, index);
+        }
+        else
+        {
+            merge(inner, index > 0 ? index - 1 : index);
+        }
+    }
+
+    // Recursively find and remove key below node, rebalancing any child
+    // left with fewer than MIN_KEYS keys on the way back up.
+    // Return false if key doesn't exist in tree, otherwise true
+    bool remove(Node* node, Key const &key)
+    {
+        if (node->leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            size_t pos = lowerBound(leaf, key);
+            if (pos == leaf->count || key < leaf->keys[pos])
+            {
+                return false;
+            }
+
+            release(leaf->data[pos]);
+            std::copy(leaf->keys + pos + 1, leaf->keys + leaf->count, leaf->keys + pos);
+            std::copy(leaf->data + pos + 1, leaf->data + leaf->count, leaf->data + pos);
+            --leaf->count;
+            return true;
+        }
+
+        Inner* inner = static_cast<Inner*>(node);
+        size_t index = childIndex(inner, key);
+        if (!remove(inner->children[index], key))
+        {
+            return false;
+        }
+
+        if (inner->children[index]->count < MIN_KEYS)
+        {
+            rebalance(inner, index);
+        }
+
+        return true;
+    }
+
+
+    // Remove the element with key from the tree, shrinking the root as needed.
+    // Return false if key doesn't exist in tree, otherwise true
+    bool removeKey(Key const &key)
+    {
+        if (root_ == nullptr || !remove(root_, key))
+        {
+            return false;
+        }
+
+        if (root_->leaf && root_->count == 0)
+        {
+            deleteNode(root_);
+            root_ = nullptr;
+            head_ = nullptr;
+            tail_ = nullptr;
+        }
+
+        // Drop an inner root that is down to a single child
+        if (root_ != nullptr && !root_->leaf && root_->count == 0)
+        {
+            Inner* oldRoot = static_cast<Inner*>(root_);
+            root_ = oldRoot->children[0];
+            delete oldRoot;
+        }
+
+        --count_;
+        return true;
+    }
+
+
+    // Find the leaf position of the first key not below key (or above it, if
+    // strict), moving on to the next leaf when the position is past the end
+    void seek(Key const &key, bool strict, Leaf* &leaf, size_t &index)
+    {
+        Node* node = root_;
+        while (node != nullptr && !node->leaf)
+        {
+            node = static_cast<Inner*>(node)->children[childIndex(static_cast<Inner*>(node), key)];
+        }
+
+        leaf = static_cast<Leaf*>(node);
+        index = 0;
+        if (leaf != nullptr)
+        {
+            index = strict ? std::upper_bound(leaf->keys, leaf->keys + leaf->count, key) - leaf->keys
+                           : lowerBound(leaf, key);
+            if (index == leaf->count)
+            {
+                leaf = leaf->next;
+                index = 0;
+            }
+        }
+    }
+
+
+    // Free a single node without touching its children or elements
+    static void deleteNode(Node* node)
+    {
+        if (node->leaf)
+        {
+            delete static_cast<Leaf*>(node);
+        }
+        else
+        {
+            delete static_cast<Inner*>(node);
+        }
+    }
+
+    // Recursively delete node and all of its descendants
+    void clear(Node* node)
+    {
+        if (node == nullptr)
+        {
+            return;
+        }
+
+        if (node->leaf)
+        {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            for (size_t i(0); i < leaf->count; ++i)
+            {
+                leaf->data[i]->~T();
+            }
+        }
+        else
+        {
+            Inner* inner = static_cast<Inner*>(node);
+            for (size_t i(0); i <= inner->count; ++i)
+            {
+                clear(inner->children[i]);
+            }
+        }
+
+        deleteNode(node);
+    }
+
+
+    public:
+
+    // Constructor
+    BTree() : root_(nullptr), head_(nullptr), tail_(nullptr), count_(0), freeSlots_(nullptr), blockUsed_(0){}
+
+    // Copy constructor
+    BTree(BTree const &rhs) : BTree()
+    {
+        for (Leaf* leaf = rhs.head_; leaf != nullptr; leaf = leaf->next)
+        {
+            for (size_t i(0); i < leaf->count; ++i)
+            {
+                insert(*leaf->data[i]);
+            }
+        }
+    }
+
+    // Swap the contents of this tree with another
+    void swap(BTree &other)
+    {
+        std::swap(root_, other.root_);
+        std::swap(head_, other.head_);
+        std::swap(tail_, other.tail_);
+        std::swap(count_, other.count_);
+        blocks_.swap(other.blocks_);
+        std::swap(freeSlots_, other.freeSlots_);
+        std::swap(blockUsed_, other.blockUsed_);
+    }
+
+    // Assignment operator
+    BTree &operator =(BTree rhs)
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    // Return true if the tree is empty, otherwise false
+    bool empty()
+    {
+        return root_ == nullptr;
+    }
+
+    // Insert new data into tree.
+    // Return false if data already exists in tree, otherwise true
+    bool insert(T data)
+    {
+        Key key = SortKey<T>::get(data);
+
+        if (root_ == nullptr)
+        {
+            Leaf* leaf = new Leaf();
+            leaf->keys[0] = key;
+            leaf->data[0] = allocate(data);
+            leaf->count = 1;
+            root_ = head_ = tail_ = leaf;
+            count_ = 1;
+            return true;
+        }
+
+        Key splitKey;
+        Node* splitNode;
+        if (!insert(root_, key, data, splitKey, splitNode))
+        {
+            return false;
+        }
+
+        if (splitNode != nullptr)
+        {
+            Inner* root = new Inner();
+            root->count = 1;
+            root->keys[0] = splitKey;
+            root->children[0] = root_;
+            root->children[1] = splitNode;
+            root_ = root;
+        }
+
+        ++count_;
+        return true;
+    }
+
+    // Find and return pointer to minimum data in tree, or null if empty tree
+    T const * findMinimum()
+    {
+        return head_ != nullptr ? head_->data[0] : nullptr;
+    }
+
+    // Find and return pointer to maximum data in tree, or null if empty tree
+    T const * findMaximum()
+    {
+        return tail_ != nullptr ? tail_->data[tail_->count - 1] : nullptr;
+    }
+
+    // Remove data from tree.
+    // Return false if data doesn't exist in tree, otherwise true
+    bool remove(T data)
+    {
+        return removeKey(SortKey<T>::get(data));
+    }
+
+    // Remove the minimum element from the tree and return it
+    T popMinimum()
+    {
+        if (head_ == nullptr)
+        {
+            throw std::logic_error("BTree::popMinimum - Tree is empty");
+        }
+
+        Key key = head_->keys[0];
+        T returnData(std::move(*head_->data[0]));
+        removeKey(key);
+        return returnData;
+    }
+
+    // Return the number of elements in the tree
+    size_t size()
+    {
+        return count_;
+    }
+
+    // Remove all elements in the tree
+    void clear()
+    {
+        clear(root_);
+        root_ = nullptr;
+        head_ = nullptr;
+        tail_ = nullptr;
+        count_ = 0;
+
+        for (Slot* block : blocks_)
+        {
+            delete [] block;
+        }
+        blocks_.clear();
+        freeSlots_ = nullptr;
+        blockUsed_ = 0;
+    }
+
+    // Return linked list of all data in tree in ascending order
+    LinkedList<T> getSortedList()
+    {
+        LinkedList<T> returnList;
+
+        // Walk the leaves backwards so pushFront leaves the list ascending
+        for (Leaf* leaf = tail_; leaf != nullptr; leaf = leaf->prev)
+        {
+            for (size_t i = leaf->count; i > 0; --i)
+            {
+                returnList.pushFront(*leaf->data[i - 1]);
+            }
+        }
+
+        return returnList;
+    }
+
+    // Return a read-only search index holding a copy of all data in tree
+    FrozenTree<T> freeze()
+    {
+        std::vector<T> sorted;
+        sorted.reserve(count_);
+        for (Leaf* leaf = head_; leaf != nullptr; leaf = leaf->next)
+        {
+            for (size_t i(0); i < leaf->count; ++i)
+            {
+                sorted.push_back(*leaf->data[i]);
+            }
+        }
+
+        return FrozenTree<T>(std::move(sorted));
+    }
+
+    // Destructor
+    ~BTree()
+    {
+        clear();
+    }
+
+
+
+    // B tree (in-order) iterator, walking the linked leaves
+    class Iterator
+    {
+        private:
+        Leaf* leaf_;
+        size_t index_;
+        Leaf* endLeaf_;
+        size_t endIndex_;
+
+        public:
+
+        // Constructor
+        Iterator(Leaf* head) : leaf_(head), index_(0), endLeaf_(nullptr), endIndex_(0){}
+
+        // Constructor for a range from one leaf position up to another
+        Iterator(Leaf* leaf, size_t index, Leaf* endLeaf, size_t endIndex)
+         : leaf_(leaf), index_(index), endLeaf_(endLeaf), endIndex_(endIndex){}
+
+        // Get immutable pointer to current element
+        T const * current()
+        {
+            if (hasNext())
+            {
+                return leaf_->data[index_];
+            }
+
+            return nullptr;
+        }
+
+        // Move to the next element
+        void next()
+        {
+            if (hasNext() && ++index_ == leaf_->count)
+            {
+                leaf_ = leaf_->next;
+                index_ = 0;
+            }
+        }
+
+        // Return true if there is a next element, otherwise false
+        bool hasNext()
+        {
+            return leaf_ != nullptr && (leaf_ != endLeaf_ || index_ != endIndex_);
+        }
+
+    };
+
+
+    // Return a new in-order iterator object
+    Iterator generateIterator()
+    {
+        return Iterator(head_);
+    }
+
+    // Return an in-order iterator over all data from low up to and including high
+    Iterator generateRange(T low, T high)
+    {
+        Key lowKey = SortKey<T>::get(low);
+        Key highKey = SortKey<T>::get(high);
+        if (highKey < lowKey)
+        {
+            return Iterator(nullptr);
+        }
+
+        Leaf* leaf;
+        size_t index;
+        Leaf* endLeaf;
+        size_t endIndex;
+        seek(lowKey, false, leaf, index);
+        seek(highKey, true, endLeaf, endIndex);
+        return Iterator(leaf, index, endLeaf, endIndex);
+    }
+
+
+
+    // STL bidirectional iterator over the linked leaves, for range-for and
+    // <algorithm>. Data can't be changed through it, since that could break
+    // the tree's order.
+    class StlIterator
+    {
+        private:
+        Leaf* leaf_;
+        size_t index_;
+        Leaf* tail_;
+
+        public:
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T const* pointer;
+        typedef T const& reference;
+
+        StlIterator() : leaf_(nullptr), index_(0), tail_(nullptr){}
+
+        // tail is kept so end() can step back to the maximum
+        StlIterator(Leaf* leaf, size_t index, Leaf* tail) : leaf_(leaf), index_(index), tail_(tail){}
+
+        reference operator *() const
+        {
+            return *leaf_->data[index_];
+        }
+
+        pointer operator ->() const
+        {
+            return leaf_->data[index_];
+        }
+
+        StlIterator &operator ++()
+        {
+            if (++index_ == leaf_->count)
+            {
+                leaf_ = leaf_->next;
+                index_ = 0;
+            }
+            return *this;
+        }
+
+        StlIterator operator ++(int)
+        {
+            StlIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        StlIterator &operator --()
+        {
+            if (leaf_ == nullptr || index_ == 0)
+            {
+                leaf_ = leaf_ == nullptr ? tail_ : leaf_->prev;
+                index_ = leaf_->count;
+            }
+            --index_;
+            return *this;
+        }
+
+        StlIterator operator --(int)
+        {
+            StlIterator previous(*this);
+            --*this;
+            return previous;
+        }
+
+        bool operator ==(StlIterator const &rhs) const
+        {
+            return leaf_ == rhs.leaf_ && index_ == rhs.index_;
+        }
+
+        bool operator !=(StlIterator const &rhs) const
+        {
+            return !(*this == rhs);
+        }
+    };
+
+    typedef StlIterator iterator;
+    typedef StlIterator const_iterator;
+
+    const_iterator begin() const
+    {
+        return const_iterator(head_, 0, tail_);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(nullptr, 0, tail_);
+    }
+
+};
+
+#endif
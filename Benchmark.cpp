@@ -0,0 +1,458 @@
+/***************************************
+Pest Control Benchmark
+Description: Generates a synthetic bug export and times
+each stage of the assignment pipeline on it: xml parsing,
+tree building and report writing.
+Build: g++ -std=c++17 -O2 -pthread Benchmark.cpp -o benchmark
+Usage: run with --help for the command line options.
+***************************************/
+
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+#include <unistd.h>
+#include "BinarySearchTree.hpp"
+#include "BTree.hpp"
+#include "MinHeap.hpp"
+#include "AssignmentPolicy.hpp"
+#include "Bug.hpp"
+#include "BugColumns.hpp"
+#include "BugGenerator.hpp"
+#include "BugParser.hpp"
+#include "Report.hpp"
+#include "ReportFile.hpp"
+using namespace std;
+
+
+// Result of one timed pipeline stage
+struct StageResult {
+    string name;
+    double seconds;
+    long peakKiB;     // peak resident set while the stage ran, or -1 if unknown
+};
+
+// Reset the kernel's peak RSS counter so the next reading covers only what follows.
+// Return false where that isn't supported; readings are then cumulative.
+bool resetPeakRss() {
+    ofstream clearRefs("/proc/self/clear_refs");
+    return clearRefs.is_open() && (clearRefs << "5").flush();
+}
+
+// Return the peak resident set size in KiB since the last reset
+long readPeakRss() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return atol(line.c_str() + 6);
+        };
+    };
+
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        return usage.ru_maxrss;
+    };
+
+    return -1;
+}
+
+// Time a single stage and record its peak RSS
+template <typename Stage>
+StageResult timeStage(string const &name, Stage stage) {
+    resetPeakRss();
+    auto start = chrono::steady_clock::now();
+    stage();
+    auto stop = chrono::steady_clock::now();
+    return StageResult{ name, chrono::duration<double>(stop - start).count(), readPeakRss() };
+}
+
+// Time the build stage with one Tree per impact level, then the write stage
+// consuming the trees oldest first
+template <typename Tree>
+void buildAndWrite(vector<Bug> &bugs, int devCount, AssignmentPolicy const &policy, string const &reportPath,
+                   vector<StageResult> &results) {
+
+    Tree bugTrees[IMPACT_COUNT];
+
+    results.push_back(timeStage("build", [&]() {
+        for (Bug &bug : bugs) {
+            bugTrees[impactCode(bug.getimpact())].insert(bug);
+        };
+    }));
+
+    results.push_back(timeStage("write", [&]() {
+        MinimumQueue<Tree> hiBugs(bugTrees[IMPACT_HIGH]);
+        MinimumQueue<Tree> midBugs(bugTrees[IMPACT_MEDIUM]);
+        MinimumQueue<Tree> loBugs(bugTrees[IMPACT_LOW]);
+        ofstream outFile(reportPath, ofstream::trunc);
+        writeReport(outFile, devCount, policy, hiBugs, midBugs, loBugs);
+    }));
+}
+
+// Time building one heap per impact level with heapify, then the write stage
+// popping the heaps oldest first
+void buildAndWriteHeaps(vector<Bug> &bugs, int devCount, AssignmentPolicy const &policy, string const &reportPath,
+                        vector<StageResult> &results) {
+
+    MinHeap<Bug> bugHeaps[IMPACT_COUNT];
+
+    results.push_back(timeStage("build", [&]() {
+        vector<Bug> impactBugs[IMPACT_COUNT];
+        for (Bug &bug : bugs) {
+            impactBugs[impactCode(bug.getimpact())].push_back(bug);
+        };
+        for (size_t impact = 0; impact < IMPACT_COUNT; impact++) {
+            bugHeaps[impact].heapify(move(impactBugs[impact]));
+        };
+    }));
+
+    results.push_back(timeStage("write", [&]() {
+        DistinctMinimumQueue<MinHeap<Bug>> hiBugs(bugHeaps[IMPACT_HIGH]);
+        DistinctMinimumQueue<MinHeap<Bug>> midBugs(bugHeaps[IMPACT_MEDIUM]);
+        DistinctMinimumQueue<MinHeap<Bug>> loBugs(bugHeaps[IMPACT_LOW]);
+        ofstream outFile(reportPath, ofstream::trunc);
+        writeReport(outFile, devCount, policy, hiBugs, midBugs, loBugs);
+    }));
+}
+
+// Time ordering the rows of a columnar table, then the write stage planning
+// the assignment, or balancing it with loadWeights, and reading the text back
+// from the table's blob. With several threads the report is written by
+// ReportFile, each thread formatting and writing its own part of the file.
+void buildAndWriteColumns(BugColumns &bugs, int devCount, AssignmentPolicy const &policy,
+                          unsigned const (*loadWeights)[IMPACT_COUNT], unsigned threads, string const &reportPath,
+                          vector<StageResult> &results) {
+
+    vector<uint32_t> impactRows[IMPACT_COUNT];
+
+    results.push_back(timeStage("build", [&]() {
+        bugs.orderRows(impactRows);
+    }));
+
+    results.push_back(timeStage("write", [&]() {
+        DeveloperRoster developers(devCount);
+        ReportLayout layout;
+        if (loadWeights) {
+            layoutBalancedReport(developers, policy, *loadWeights, bugs, impactRows, layout);
+        } else {
+            layoutReport(developers, policy, impactRows, layout);
+        };
+
+        if (threads > 1) {
+            ReportFile(developers, bugs, layout).write(reportPath, threads);
+        } else {
+            ofstream outFile(reportPath, ofstream::trunc);
+            writeReport(outFile, developers, bugs, layout);
+        };
+    }));
+}
+
+void printUsage(ostream &out, char const *program) {
+    out<<"Usage: "<<program<<" [options]\n"
+       <<"  -n, --bugs <n>                 number of bugs to generate (default 1000)\n"
+       <<"      --order <order>            random, sorted, reverse or duplicates (default random)\n"
+       <<"      --impact <h,m,l>           relative impact weights (default 17,13,20)\n"
+       <<"      --description-length <n>   average description length (default 100)\n"
+       <<"      --distinct-descriptions <n>\n"
+       <<"                                 draw descriptions from n distinct texts (default all distinct)\n"
+       <<"      --seed <n>                 generator seed (default 1)\n"
+       <<"  -d, --developers <n>           developers to assign (default 100)\n"
+       <<"      --container <bst|btree|heap|columns>\n"
+       <<"                                 container for the build stage (default bst)\n"
+       <<"      --intern-descriptions      with --container columns, store repeated descriptions once\n"
+       <<"      --quota <h,m,l>            high, medium and low bugs per developer (default 1,1,1)\n"
+       <<"      --capacity <n>             most bugs any developer takes (default no limit)\n"
+       <<"      --seniors <n>              the first n developers take --senior-quota instead\n"
+       <<"      --senior-quota <h,m,l>     bugs per senior developer (default 2,1,1)\n"
+       <<"      --balance                  with --container columns, give each bug to the least loaded\n"
+       <<"                                 developer; without --quota only --capacity limits them\n"
+       <<"      --weights <h,m,l>          load a high, medium and low bug adds when balancing (default 3,2,1)\n"
+       <<"  -j, --threads <n>              with --container columns, write the report on n threads (default 1)\n"
+       <<"  -r, --repeat <n>               run the pipeline n times, reporting each (default 1)\n"
+       <<"      --scale <steps>            repeat everything steps times, doubling --bugs and --developers\n"
+       <<"                                 each time, to check the cost per bug and developer stays flat\n"
+       <<"  -i, --input <bugs.xml>         benchmark an existing export instead of generating one\n"
+       <<"      --generate <bugs.xml>      only write the generated export and exit\n"
+       <<"      --json                     print results as one JSON object per run\n"
+       <<"  -h, --help                     show this message\n"
+       <<"Sorted and reverse orders turn the unbalanced BST into a list, so keep --bugs small for them\n"
+       <<"unless benchmarking --container btree or heap.\n";
+}
+
+// Parse a non-negative count argument.
+// Return false if text isn't a number in range.
+bool parseCount(char const *text, unsigned long long maximum, unsigned long long &value) {
+    char *end = nullptr;
+    errno = 0;
+    value = strtoull(text, &end, 10);
+    return errno == 0 && text[0] >= '0' && text[0] <= '9' && *end == '\0' && value <= maximum;
+}
+
+int main(int argc, char *argv[]) {
+
+    BugGenerator generator;
+    uint64_t seed = 1;
+    int devCount = 100;
+    int repeat = 1;
+    bool json = false;
+    string inputPath;
+    string generatePath;
+    string container = "bst";
+    bool internDescriptions = false;
+    DeveloperQuota quota = { { 1, 1, 1 }, UINT_MAX };
+    DeveloperQuota seniorQuota = { { 2, 1, 1 }, UINT_MAX };
+    int seniorCount = 0;
+    bool quotaGiven = false;
+    bool balance = false;
+    unsigned loadWeights[IMPACT_COUNT] = { 3, 2, 1 };
+    unsigned threads = 1;
+    int scaleSteps = 1;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        unsigned long long value = 0;
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(cout, argv[0]);
+            return 0;
+        } else if ((arg == "-n" || arg == "--bugs") && hasValue) {
+            if (!parseCount(argv[++i], UINT32_MAX, value)) {
+                cerr<<"Invalid bug count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            generator.bugCount = value;
+        } else if (arg == "--order" && hasValue) {
+            if (!BugGenerator::parseOrder(argv[++i], generator.order)) {
+                cerr<<"Unknown date order \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+        } else if (arg == "--impact" && hasValue) {
+            if (!parseImpactCounts(argv[++i], generator.impactWeights)) {
+                cerr<<"Impact weights must look like 17,13,20\n";
+                return 1;
+            };
+        } else if (arg == "--description-length" && hasValue) {
+            if (!parseCount(argv[++i], UINT32_MAX, value)) {
+                cerr<<"Invalid description length \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            generator.descriptionLength = value;
+        } else if (arg == "--distinct-descriptions" && hasValue) {
+            if (!parseCount(argv[++i], UINT32_MAX, value)) {
+                cerr<<"Invalid distinct description count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            generator.distinctDescriptions = value;
+        } else if (arg == "--seed" && hasValue) {
+            if (!parseCount(argv[++i], ULLONG_MAX, value)) {
+                cerr<<"Invalid seed \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            seed = value;
+        } else if ((arg == "-d" || arg == "--developers") && hasValue) {
+            if (!parseCount(argv[++i], 1000000000, value)) {
+                cerr<<"Invalid developer count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            devCount = static_cast<int>(value);
+        } else if (arg == "--container" && hasValue) {
+            container = argv[++i];
+            if (container != "bst" && container != "btree" && container != "heap" && container != "columns") {
+                cerr<<"Unknown container \""<<container<<"\"\n";
+                return 1;
+            };
+        } else if (arg == "--intern-descriptions") {
+            internDescriptions = true;
+        } else if ((arg == "--quota" || arg == "--senior-quota") && hasValue) {
+            if (!parseQuota(argv[++i], arg == "--quota" ? quota : seniorQuota)) {
+                cerr<<"Quotas must look like 1,1,1\n";
+                return 1;
+            };
+            quotaGiven = quotaGiven || arg == "--quota";
+        } else if (arg == "--capacity" && hasValue) {
+            if (!parseCount(argv[++i], UINT_MAX, value)) {
+                cerr<<"Invalid capacity \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            quota.capacity = static_cast<unsigned>(value);
+            seniorQuota.capacity = quota.capacity;
+        } else if (arg == "--seniors" && hasValue) {
+            if (!parseCount(argv[++i], 1000000000, value)) {
+                cerr<<"Invalid senior developer count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            seniorCount = static_cast<int>(value);
+        } else if (arg == "--balance") {
+            balance = true;
+        } else if (arg == "--weights" && hasValue) {
+            if (!parseImpactCounts(argv[++i], loadWeights)) {
+                cerr<<"Weights must look like 3,2,1\n";
+                return 1;
+            };
+        } else if ((arg == "-j" || arg == "--threads") && hasValue) {
+            if (!parseCount(argv[++i], 1024, value) || value == 0) {
+                cerr<<"Invalid thread count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            threads = static_cast<unsigned>(value);
+        } else if ((arg == "-r" || arg == "--repeat") && hasValue) {
+            if (!parseCount(argv[++i], 1000000, value) || value == 0) {
+                cerr<<"Invalid repeat count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            repeat = static_cast<int>(value);
+        } else if (arg == "--scale" && hasValue) {
+            if (!parseCount(argv[++i], 32, value) || value == 0) {
+                cerr<<"Invalid scale step count \""<<argv[i]<<"\"\n";
+                return 1;
+            };
+            scaleSteps = static_cast<int>(value);
+        } else if ((arg == "-i" || arg == "--input") && hasValue) {
+            inputPath = argv[++i];
+        } else if (arg == "--generate" && hasValue) {
+            generatePath = argv[++i];
+        } else if (arg == "--json") {
+            json = true;
+        } else {
+            cerr<<"Unknown or incomplete option \""<<arg<<"\"\n";
+            printUsage(cerr, argv[0]);
+            return 1;
+        };
+    };
+
+    if (internDescriptions && container != "columns") {
+        cerr<<"--intern-descriptions needs --container columns\n";
+        return 1;
+    };
+
+    if (balance && container != "columns") {
+        cerr<<"--balance needs --container columns\n";
+        return 1;
+    };
+    if (balance && !quotaGiven) {
+        quota.perImpact[IMPACT_HIGH] = UINT_MAX;
+        quota.perImpact[IMPACT_MEDIUM] = UINT_MAX;
+        quota.perImpact[IMPACT_LOW] = UINT_MAX;
+    };
+
+    if (scaleSteps > 1 && !inputPath.empty()) {
+        cerr<<"--scale needs a generated export, not --input\n";
+        return 1;
+    };
+    if ((generator.bugCount << (scaleSteps - 1)) > UINT32_MAX
+        || (static_cast<unsigned long long>(devCount) << (scaleSteps - 1)) > INT_MAX) {
+        cerr<<"--scale doubles --bugs or --developers past their limits\n";
+        return 1;
+    };
+
+    unique_ptr<AssignmentPolicy> policy;
+    if (seniorCount > 0) {
+        policy.reset(new SeniorityPolicy(seniorCount, seniorQuota, quota));
+    } else {
+        policy.reset(new UniformPolicy(quota));
+    };
+
+    generator.reseed(seed);
+
+    if (!generatePath.empty()) {
+        if (!generator.write(generatePath)) {
+            cerr<<"Can't write "<<generatePath<<"!"<<endl;
+            return 1;
+        };
+        return 0;
+    };
+
+    // Generated input and the report both live in the temp directory for the run
+    string tag = "pest-control-bench-" + to_string(getpid());
+    filesystem::path tempDir = filesystem::temp_directory_path();
+    string reportPath = (tempDir / (tag + "-report.xml")).string();
+    bool generated = inputPath.empty();
+    if (generated) {
+        inputPath = (tempDir / (tag + ".xml")).string();
+    };
+
+    int status = 0;
+
+    for (int step = 0; step < scaleSteps && status == 0; step++) {
+        if (step > 0) {
+            generator.bugCount *= 2;
+            devCount *= 2;
+            generator.reseed(seed);
+        };
+
+        if (generated) {
+            StageResult generate = timeStage("generate", [&]() { generator.write(inputPath); });
+            if (!json) {
+                cout<<"generated "<<generator.bugCount<<" bugs in "<<generate.seconds<<" s"<<endl;
+            };
+        };
+
+        for (int run = 0; run < repeat; run++) {
+
+            //columns parses straight into the columnar table instead of Bugs
+            vector<Bug> bugs;
+            BugColumns bugColumns(internDescriptions);
+            bool parsed = false;
+            vector<StageResult> results;
+
+            results.push_back(timeStage("parse", [&]() {
+                BugParser parser;
+                parsed = container == "columns" ? parser.load(inputPath, bugColumns) : parser.load(inputPath, bugs);
+            }));
+            if (!parsed) {
+                status = 1;
+                break;
+            };
+            size_t bugCount = container == "columns" ? bugColumns.size() : bugs.size();
+
+            if (container == "columns") {
+                buildAndWriteColumns(bugColumns, devCount, *policy, balance ? &loadWeights : nullptr, threads,
+                                     reportPath, results);
+            } else if (container == "heap") {
+                buildAndWriteHeaps(bugs, devCount, *policy, reportPath, results);
+            } else if (container == "btree") {
+                buildAndWrite<BTree<Bug>>(bugs, devCount, *policy, reportPath, results);
+            } else {
+                buildAndWrite<BinarySearchTree<Bug>>(bugs, devCount, *policy, reportPath, results);
+            };
+
+            if (json) {
+                cout<<"{\"run\":"<<run<<",\"bugs\":"<<bugCount<<",\"developers\":"<<devCount
+                    <<",\"container\":\""<<container<<"\",\"stages\":{";
+                for (size_t s = 0; s < results.size(); s++) {
+                    cout<<(s ? "," : "")<<"\""<<results[s].name<<"\":{\"seconds\":"<<results[s].seconds
+                        <<",\"peak_rss_kib\":"<<results[s].peakKiB<<"}";
+                };
+                cout<<"}}"<<endl;
+            } else {
+                cout<<"run "<<run<<": "<<bugCount<<" bugs, "<<devCount<<" developers, "<<container<<endl;
+                for (StageResult const &result : results) {
+                    cout<<"  "<<result.name<<string(8 - result.name.size(), ' ')<<result.seconds*1000.0
+                        <<" ms, peak rss "<<result.peakKiB<<" KiB"<<endl;
+                };
+                if (scaleSteps > 1) {
+                    cout<<"  write per bug and developer "<<results.back().seconds*1e9/(bugCount + devCount)
+                        <<" ns"<<endl;
+                };
+            };
+        };
+    };
+
+    if (generated) {
+        filesystem::remove(inputPath);
+    };
+    filesystem::remove(reportPath);
+
+    return status;
+}
@@ -2,7 +2,13 @@
 #ifndef BINARY_SEARCH_TREE_HPP
 #define BINARY_SEARCH_TREE_HPP
 
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+#include <vector>
 #include "LinkedList.hpp"
+#include "FrozenTree.hpp"
 
 template <typename T>
 class BinarySearchTree
@@ -13,9 +19,10 @@ class BinarySearchTree
     {
         Node* leftChild;
         Node* rightChild;
+        Node* parent;
         T data;
 
-        Node(T d) : data(d), leftChild(nullptr), rightChild(nullptr){}
+        Node(T d, Node* p) : data(d), leftChild(nullptr), rightChild(nullptr), parent(p){}
     }* root_;
 
 
@@ -24,9 +31,17 @@ class BinarySearchTree
     {
         if (nodeToCopy != nullptr)
         {
-            Node* newNode = new Node(nodeToCopy->data);
+            Node* newNode = new Node(nodeToCopy->data, nullptr);
             newNode->leftChild = copyNode(nodeToCopy->leftChild);
             newNode->rightChild = copyNode(nodeToCopy->rightChild);
+            if (newNode->leftChild != nullptr)
+            {
+                newNode->leftChild->parent = newNode;
+            }
+            if (newNode->rightChild != nullptr)
+            {
+                newNode->rightChild->parent = newNode;
+            }
             return newNode;
         }
 
@@ -36,20 +51,20 @@ class BinarySearchTree
 
     // Recursively determine proper location in tree and insert new data.
     // Return false if data already exists in tree, otherwise true
-    bool insert(T &data, Node* &subRoot)
+    bool insert(T &data, Node* &subRoot, Node* parent)
     {
         if (subRoot == nullptr)
         {
-            subRoot = new Node(data);
+            subRoot = new Node(data, parent);
             return true;
         }
         else if (data < subRoot->data)
         {
-            return insert(data, subRoot->leftChild);
+            return insert(data, subRoot->leftChild, subRoot);
         }
         else if (data > subRoot->data)
         {
-            return insert(data, subRoot->rightChild);
+            return insert(data, subRoot->rightChild, subRoot);
         }
 
         return false;
@@ -118,12 +133,14 @@ class BinarySearchTree
             {
                 Node* temp = subRoot;
                 subRoot = subRoot->rightChild;
+                subRoot->parent = temp->parent;
                 delete temp;
             }
             else if (subRoot->rightChild == nullptr)
             {
                 Node* temp = subRoot;
                 subRoot = subRoot->leftChild;
+                subRoot->parent = temp->parent;
                 delete temp;
             }
             // Case 3: Two children
@@ -186,6 +203,40 @@ class BinarySearchTree
     }
 
 
+
+    // Return the leftmost node below subRoot
+    static Node* leftmost(Node* subRoot)
+    {
+        while (subRoot->leftChild != nullptr)
+        {
+            subRoot = subRoot->leftChild;
+        }
+        return subRoot;
+    }
+
+    // Return the rightmost node below subRoot
+    static Node* rightmost(Node* subRoot)
+    {
+        while (subRoot->rightChild != nullptr)
+        {
+            subRoot = subRoot->rightChild;
+        }
+        return subRoot;
+    }
+
+
+    // Recursively append all tree data to "sorted" parameter in ascending order
+    void appendSorted(Node* subRoot, std::vector<T> &sorted)
+    {
+        if (subRoot != nullptr)
+        {
+            appendSorted(subRoot->leftChild, sorted);
+            sorted.push_back(subRoot->data);
+            appendSorted(subRoot->rightChild, sorted);
+        }
+    }
+
+
     
     public:
 
@@ -223,7 +274,7 @@ class BinarySearchTree
     // Return false if data already exists in tree, otherwise true
     bool insert(T data)
     {
-        return insert(data, root_);
+        return insert(data, root_, nullptr);
     }
 
     // Find and return pointer to minimum data in tree, or null if emptry tree
@@ -257,6 +308,32 @@ class BinarySearchTree
         return remove(data, root_);
     }
 
+    // Unlink the minimum node from the tree and return its data
+    T popMinimum()
+    {
+        if (root_ == nullptr)
+        {
+            throw std::logic_error("BinarySearchTree::popMinimum - Tree is empty");
+        }
+
+        // The minimum has no left child, so its right subtree takes its place
+        Node** link = &root_;
+        while ((*link)->leftChild != nullptr)
+        {
+            link = &(*link)->leftChild;
+        }
+
+        Node* min = *link;
+        *link = min->rightChild;
+        if (min->rightChild != nullptr)
+        {
+            min->rightChild->parent = min->parent;
+        }
+        T returnData(std::move(min->data));
+        delete min;
+        return returnData;
+    }
+
     // Return the number of nodes in the tree
     size_t size()
     {
@@ -277,6 +354,14 @@ class BinarySearchTree
         return returnList;
     }
 
+    // Return a read-only search index holding a copy of all data in tree
+    FrozenTree<T> freeze()
+    {
+        std::vector<T> sorted;
+        appendSorted(root_, sorted);
+        return FrozenTree<T>(std::move(sorted));
+    }
+
     // Destructor
     ~BinarySearchTree()
     {
@@ -285,31 +370,109 @@ class BinarySearchTree
 
 
 
+    // Stack of nodes for the iterator. The first INLINE_CAPACITY entries live
+    // in the stack itself, which covers any reasonably balanced tree without
+    // allocating; deeper paths spill over into a vector.
+    class NodeStack
+    {
+        private:
+        static size_t const INLINE_CAPACITY = 48;
+
+        Node* inline_[INLINE_CAPACITY];
+        std::vector<Node*> spill_;
+        size_t size_;
+
+        public:
+
+        // Constructor
+        NodeStack() : size_(0){}
+
+        // Return true if the stack is empty, otherwise false
+        bool empty() const
+        {
+            return size_ == 0;
+        }
+
+        // Return the node on top of the stack; the stack must not be empty
+        Node* top() const
+        {
+            return size_ <= INLINE_CAPACITY ? inline_[size_ - 1] : spill_.back();
+        }
+
+        // Push a node onto the stack
+        void push(Node* node)
+        {
+            if (size_ < INLINE_CAPACITY)
+            {
+                inline_[size_] = node;
+            }
+            else
+            {
+                spill_.push_back(node);
+            }
+            ++size_;
+        }
+
+        // Remove and return the node on top of the stack; the stack must not be empty
+        Node* pop()
+        {
+            Node* node = top();
+            if (size_ > INLINE_CAPACITY)
+            {
+                spill_.pop_back();
+            }
+            --size_;
+            return node;
+        }
+    };
+
+
+
     // Binary Search Tree (in-order) iterator
     class Iterator
     {
         private:
-        LinkedList<Node*> nodeStack_;
+        NodeStack nodeStack_;
+        Node* end_;
 
         public:
         
         // Constructor
-        Iterator(Node* root)
+        Iterator(Node* root) : end_(nullptr)
         {
             // Push all left children onto stack
             while (root != nullptr)
             {
-                nodeStack_.pushFront(root);
+                nodeStack_.push(root);
                 root = root->leftChild;
             }
         }
 
+        // Constructor for a range: start at the first node not below low and
+        // stop before end, the first node past the range (null to run to the end)
+        Iterator(Node* root, T &low, Node* end) : end_(end)
+        {
+            // Push only the nodes on the path to low that come after it
+            while (root != nullptr)
+            {
+                if (root->data < low)
+                {
+                    root = root->rightChild;
+                }
+                else
+                {
+                    nodeStack_.push(root);
+                    root = root->leftChild;
+                }
+            }
+        }
+
         // Get immutable pointer to current node's data 
         T const * current()
         {
-            if (!nodeStack_.empty())
+            if (hasNext())
             {
-                return &nodeStack_.at(0)->data;
+                return &nodeStack_.top()->data;
             }
 
             return nullptr;
@@ -319,12 +482,12 @@ class BinarySearchTree
         // Move to the next node
         void next()
         {
-            if (!nodeStack_.empty())
+            if (hasNext())
             {
-                Node* temp = nodeStack_.popFront()->rightChild;
+                Node* temp = nodeStack_.pop()->rightChild;
                 while (temp != nullptr)
                 {
-                    nodeStack_.pushFront(temp);
+                    nodeStack_.push(temp);
                     temp = temp->leftChild;
                 }
             }
@@ -333,7 +496,7 @@ class BinarySearchTree
         // Return true if there is a next node, otherwise false
         bool hasNext()
         {
-            return !nodeStack_.empty();
+            return !nodeStack_.empty() && nodeStack_.top() != end_;
         }
 
     };
@@ -345,6 +508,149 @@ class BinarySearchTree
         return Iterator(root_);
     }
 
+    // Return an in-order iterator over all data from low up to and including
+    // high. Both ends are found by descending the tree, and nothing is copied.
+    Iterator generateRange(T low, T high)
+    {
+        if (high < low)
+        {
+            return Iterator(nullptr);
+        }
+
+        // The first node above high is where the range stops
+        Node* end = nullptr;
+        for (Node* subRoot = root_; subRoot != nullptr; )
+        {
+            if (high < subRoot->data)
+            {
+                end = subRoot;
+                subRoot = subRoot->leftChild;
+            }
+            else
+            {
+                subRoot = subRoot->rightChild;
+            }
+        }
+
+        return Iterator(root_, low, end);
+    }
+
+
+
+    // STL bidirectional iterator, for range-for and <algorithm>. Data can't
+    // be changed through it, since that could break the tree's order.
+    class StlIterator
+    {
+        private:
+        Node* node_;
+        Node* const * root_;
+
+        public:
+
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T const* pointer;
+        typedef T const& reference;
+
+        StlIterator() : node_(nullptr), root_(nullptr){}
+
+        // root is kept so end() can step back to the maximum
+        StlIterator(Node* node, Node* const * root) : node_(node), root_(root){}
+
+        reference operator *() const
+        {
+            return node_->data;
+        }
+
+        pointer operator ->() const
+        {
+            return &node_->data;
+        }
+
+        // Move to the in-order successor: the leftmost node of the right
+        // subtree, or else the first ancestor reached from its left side
+        StlIterator &operator ++()
+        {
+            if (node_->rightChild != nullptr)
+            {
+                node_ = leftmost(node_->rightChild);
+            }
+            else
+            {
+                Node* child = node_;
+                node_ = node_->parent;
+                while (node_ != nullptr && child == node_->rightChild)
+                {
+                    child = node_;
+                    node_ = node_->parent;
+                }
+            }
+            return *this;
+        }
+
+        StlIterator operator ++(int)
+        {
+            StlIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        // Move to the in-order predecessor; from end() that is the maximum
+        StlIterator &operator --()
+        {
+            if (node_ == nullptr)
+            {
+                node_ = rightmost(*root_);
+            }
+            else if (node_->leftChild != nullptr)
+            {
+                node_ = rightmost(node_->leftChild);
+            }
+            else
+            {
+                Node* child = node_;
+                node_ = node_->parent;
+                while (node_ != nullptr && child == node_->leftChild)
+                {
+                    child = node_;
+                    node_ = node_->parent;
+                }
+            }
+            return *this;
+        }
+
+        StlIterator operator --(int)
+        {
+            StlIterator previous(*this);
+            --*this;
+            return previous;
+        }
+
+        bool operator ==(StlIterator const &rhs) const
+        {
+            return node_ == rhs.node_;
+        }
+
+        bool operator !=(StlIterator const &rhs) const
+        {
+            return node_ != rhs.node_;
+        }
+    };
+
+    typedef StlIterator iterator;
+    typedef StlIterator const_iterator;
+
+    const_iterator begin() const
+    {
+        return const_iterator(root_ != nullptr ? leftmost(root_) : nullptr, &root_);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(nullptr, &root_);
+    }
+
 };
 
 #endif
\ No newline at end of file
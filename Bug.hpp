@@ -0,0 +1,300 @@
+#ifndef BUG_HPP
+#define BUG_HPP
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include "BugId.hpp"
+#include "FixedString.hpp"
+#include "StringPool.hpp"
+
+
+// Impact levels, in assignment order. Anything that isn't
+// "high" or "medium" is treated as low impact.
+enum Impact : uint8_t
+{
+    IMPACT_HIGH = 0,
+    IMPACT_MEDIUM = 1,
+    IMPACT_LOW = 2,
+    IMPACT_COUNT = 3
+};
+
+// Return the impact level for an <impact> element value
+inline uint8_t impactCode(std::string_view impact)
+{
+    if (impact == "high")
+    {
+        return IMPACT_HIGH;
+    }
+    else if (impact == "medium")
+    {
+        return IMPACT_MEDIUM;
+    }
+
+    return IMPACT_LOW;
+}
+
+// Return the <impact> element value for an impact level
+inline char const * impactName(uint8_t impact)
+{
+    static char const * const names[IMPACT_COUNT] = { "high", "medium", "low" };
+    return impact < IMPACT_COUNT ? names[impact] : names[IMPACT_LOW];
+}
+
+
+// Helper to convert a proleptic Gregorian date to days since 1970-01-01
+inline int64_t daysFromCivil(int64_t y, unsigned m, unsigned d)
+{
+    y -= m <= 2;
+    int64_t const era = (y >= 0 ? y : y - 399) / 400;
+    unsigned const yoe = static_cast<unsigned>(y - era * 400);
+    unsigned const doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    unsigned const doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+// Parse a <created> timestamp ("20191108T175028Z") into seconds since the Unix epoch.
+// Return false if the timestamp isn't in that format.
+inline bool parseTimestamp(std::string_view date, int64_t &seconds)
+{
+    if (date.size() != 16 || date[8] != 'T' || date[15] != 'Z')
+    {
+        return false;
+    }
+
+    unsigned digits[14];
+    size_t count(0);
+    for (size_t i(0); i < 15; ++i)
+    {
+        if (i == 8)
+        {
+            continue;
+        }
+        if (date[i] < '0' || date[i] > '9')
+        {
+            return false;
+        }
+        digits[count++] = static_cast<unsigned>(date[i] - '0');
+    }
+
+    int64_t year = digits[0] * 1000 + digits[1] * 100 + digits[2] * 10 + digits[3];
+    unsigned month = digits[4] * 10 + digits[5];
+    unsigned day = digits[6] * 10 + digits[7];
+    unsigned hour = digits[8] * 10 + digits[9];
+    unsigned minute = digits[10] * 10 + digits[11];
+    unsigned second = digits[12] * 10 + digits[13];
+
+    if (month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+    {
+        return false;
+    }
+
+    seconds = daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    return true;
+}
+
+// Format seconds since the Unix epoch as a <created> timestamp ("20191108T175028Z")
+inline std::string formatTimestamp(int64_t seconds)
+{
+    int64_t days = seconds / 86400;
+    int64_t rem = seconds % 86400;
+    if (rem < 0)
+    {
+        rem += 86400;
+        --days;
+    }
+
+    // Inverse of daysFromCivil
+    days += 719468;
+    int64_t const era = (days >= 0 ? days : days - 146096) / 146097;
+    unsigned const doe = static_cast<unsigned>(days - era * 146097);
+    unsigned const yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    unsigned const doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    unsigned const mp = (5 * doy + 2) / 153;
+    unsigned const day = doy - (153 * mp + 2) / 5 + 1;
+    unsigned const month = mp < 10 ? mp + 3 : mp - 9;
+    int64_t const year = static_cast<int64_t>(yoe) + era * 400 + (month <= 2);
+
+    unsigned fields[6] = { static_cast<unsigned>(year), month, day,
+                           static_cast<unsigned>(rem / 3600),
+                           static_cast<unsigned>(rem / 60 % 60),
+                           static_cast<unsigned>(rem % 60) };
+
+    std::string date("00000000T000000Z");
+    static size_t const ends[6] = { 4, 6, 8, 11, 13, 15 };
+    for (size_t f(0); f < 6; ++f)
+    {
+        size_t pos = ends[f];
+        unsigned value = fields[f];
+        size_t width = f == 0 ? 4 : 2;
+        for (size_t i(0); i < width; ++i)
+        {
+            date[--pos] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    }
+
+    return date;
+}
+
+
+template <typename T> struct SortKey;
+
+class Bug {
+
+    friend struct SortKey<Bug>;
+
+    public:
+
+    // Longest <impact> ("medium") and <created> ("20191108T175028Z") values stored inline
+    static size_t const IMPACT_CAPACITY = 6;
+    static size_t const DATE_CAPACITY = 16;
+
+    private:
+    BugId m_id;
+    std::string m_description;
+    FixedString<IMPACT_CAPACITY> m_impact;
+    FixedString<DATE_CAPACITY> m_date;
+
+    public:
+
+    //parameterized constructor
+    Bug(std::string_view id, std::string description, std::string_view impact, std::string_view date)
+     : m_id(id), m_description(std::move(description)), m_impact(impact), m_date(date) {};
+
+    Bug(BugId id, std::string description, std::string_view impact, std::string_view date)
+     : m_id(id), m_description(std::move(description)), m_impact(impact), m_date(date) {};
+
+    // // Setter  **don't need setters
+    // void setid(string s) {
+    //   m_id = s;
+    // }
+
+    std::string getid()
+    {
+        return m_id.str();
+    }
+
+    BugId getbugid()
+    {
+        return m_id;
+    }
+
+    std::string getdescription() {
+        return m_description;
+    }
+
+    std::string getimpact()
+    {
+        return m_impact.str();
+    }
+
+    std::string getdate()
+    {
+        return m_date.str();
+    }
+
+
+    bool operator < (Bug const &rhs) {
+        if (m_date < rhs.m_date) {
+            return true;
+        }
+
+        return false;
+    }
+
+    bool operator > (Bug const &rhs) {
+        if (m_date > rhs.m_date) {
+            return true;
+        }
+
+        return false;
+    }
+
+
+};
+
+
+// Ordered containers key bugs by created date, packed big-endian into two words so key
+// order matches Bug's date comparison. The first 16 characters cover every
+// well-formed timestamp; anything past them is interned in a process-wide
+// pool and only compared, as text, when two keys share their first 16
+// characters, so the key orders and tells apart every date exactly. Like
+// FixedString's overflow pool, the tails are never freed and comparing two
+// of them takes the pool's mutex; well-formed dates never reach either.
+template <>
+struct SortKey<Bug>
+{
+    private:
+
+    struct Tails
+    {
+        std::mutex mutex;
+        StringPool pool;
+
+        Tails() : pool(true){}
+    };
+
+    static Tails &tails()
+    {
+        static Tails table;
+        return table;
+    }
+
+    public:
+
+    struct type
+    {
+        uint64_t high;
+        uint64_t low;
+        uint32_t tail;      // 0, or 1 + the pool handle of the characters past the 16th
+
+        bool operator <(type const &rhs) const
+        {
+            if (high != rhs.high || low != rhs.low)
+            {
+                return high < rhs.high || (high == rhs.high && low < rhs.low);
+            }
+            if (tail == rhs.tail || rhs.tail == 0)
+            {
+                return false;
+            }
+            if (tail == 0)
+            {
+                return true;
+            }
+
+            Tails &table = tails();
+            std::lock_guard<std::mutex> lock(table.mutex);
+            return table.pool.get(tail - 1) < table.pool.get(rhs.tail - 1);
+        }
+    };
+
+    static type get(Bug const &bug)
+    {
+        return fromDate(bug.m_date.view());
+    }
+
+    // Key for a <created> value
+    static type fromDate(std::string_view date)
+    {
+        type key = { 0, 0, 0 };
+        for (size_t i(0); i < 16; ++i)
+        {
+            uint64_t c = i < date.size() ? static_cast<unsigned char>(date[i]) : 0;
+            (i < 8 ? key.high : key.low) |= c << (8 * (7 - i % 8));
+        }
+
+        if (date.size() > 16)
+        {
+            Tails &table = tails();
+            std::lock_guard<std::mutex> lock(table.mutex);
+            key.tail = table.pool.add(date.substr(16)) + 1;
+        }
+        return key;
+    }
+};
+
+#endif
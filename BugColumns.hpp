@@ -0,0 +1,253 @@
+#ifndef BUG_COLUMNS_HPP
+#define BUG_COLUMNS_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+#include "Bug.hpp"
+#include "BugId.hpp"
+#include "SortKey.hpp"
+#include "StringPool.hpp"
+
+
+// In-memory columnar bug table, the resident counterpart of a BugStore file.
+//
+//   keys          [count] SortKey<Bug>   <created> packed into 24 bytes
+//   impacts       [count] uint8          impact level
+//   ids           [count] BugId          bug id
+//   descriptions  [count] uint32         handle into the description pool
+//   offsets       [2 * count + 1]        start of each row's impact and
+//                                        created text in the blob
+//   blob                                 impact and created text, back to back
+//
+// Ordering and assigning bugs only reads keys and impacts, 25 bytes per bug;
+// the text stays untouched until the report is written. Unlike a store the
+// text is kept verbatim, so unusual impacts and dates are written back
+// exactly as they were read.
+//
+// With internDescriptions the description pool is hash-consed, so exports
+// full of identical crash messages keep one copy of each message, and rows
+// with the same description have the same handle.
+class BugColumns
+{
+    private:
+
+    typedef SortKey<Bug>::type Key;
+
+    std::vector<Key> keys_;
+    std::vector<uint8_t> impacts_;
+    std::vector<BugId> ids_;
+    std::vector<uint32_t> descriptions_;
+    StringPool descriptionPool_;
+    std::vector<uint64_t> offsets_;
+    std::vector<char> blob_;
+
+    // Return the text between two consecutive offsets
+    std::string_view text(size_t field) const
+    {
+        return std::string_view(blob_.data() + offsets_[field], offsets_[field + 1] - offsets_[field]);
+    }
+
+    // Append text to the blob and close its field
+    void appendText(std::string_view text)
+    {
+        blob_.insert(blob_.end(), text.begin(), text.end());
+        offsets_.push_back(blob_.size());
+    }
+
+    public:
+
+    // A single bug, pointing into the pool and the blob
+    struct Record
+    {
+        BugId id;
+        uint32_t descriptionHandle;
+        std::string_view description;
+        std::string_view impact;
+        std::string_view date;
+    };
+
+    // Constructor
+    explicit BugColumns(bool internDescriptions = false) : descriptionPool_(internDescriptions), offsets_(1, 0){}
+
+    // Return true if the table is empty, otherwise false
+    bool empty() const
+    {
+        return keys_.empty();
+    }
+
+    // Return the number of bugs in the table
+    size_t size() const
+    {
+        return keys_.size();
+    }
+
+    // Add a bug at the end of the table
+    void add(BugId id, std::string_view description, std::string_view impact, std::string_view date)
+    {
+        if (keys_.size() >= UINT32_MAX)
+        {
+            throw std::length_error("BugColumns::add - Too many bugs");
+        }
+
+        keys_.push_back(SortKey<Bug>::fromDate(date));
+        impacts_.push_back(impactCode(impact));
+        ids_.push_back(id);
+        descriptions_.push_back(descriptionPool_.add(description));
+        appendText(impact);
+        appendText(date);
+    }
+
+    // Add every bug of other at the end of the table
+    void append(BugColumns const &other)
+    {
+        if (empty() && descriptionPool_.interning() == other.descriptionPool_.interning())
+        {
+            *this = other;
+            return;
+        }
+
+        uint64_t base = blob_.size();
+        keys_.insert(keys_.end(), other.keys_.begin(), other.keys_.end());
+        impacts_.insert(impacts_.end(), other.impacts_.begin(), other.impacts_.end());
+        ids_.insert(ids_.end(), other.ids_.begin(), other.ids_.end());
+        for (uint32_t handle : other.descriptions_)
+        {
+            descriptions_.push_back(descriptionPool_.add(other.descriptionPool_.get(handle)));
+        }
+        for (size_t i(1); i < other.offsets_.size(); ++i)
+        {
+            offsets_.push_back(base + other.offsets_[i]);
+        }
+        blob_.insert(blob_.end(), other.blob_.begin(), other.blob_.end());
+    }
+
+    // Remove every bug
+    void clear()
+    {
+        keys_.clear();
+        impacts_.clear();
+        ids_.clear();
+        descriptions_.clear();
+        descriptionPool_.clear();
+        offsets_.assign(1, 0);
+        blob_.clear();
+    }
+
+    // Return the number of bugs of an impact level
+    size_t count(uint8_t impact) const
+    {
+        return static_cast<size_t>(std::count(impacts_.begin(), impacts_.end(), impact));
+    }
+
+    // Return the pool holding the descriptions
+    StringPool const &descriptionPool() const
+    {
+        return descriptionPool_;
+    }
+
+    // Return the sort key, the packed created date, of the bug at row
+    SortKey<Bug>::type key(size_t row) const
+    {
+        return keys_[row];
+    }
+
+    // Return the bug stored at row
+    Record at(size_t row) const
+    {
+        uint32_t description = descriptions_[row];
+        return Record{ ids_[row], description, descriptionPool_.get(description), text(2 * row), text(2 * row + 1) };
+    }
+
+    // Fill rows with the rows of each impact level, oldest first. Of several
+    // bugs with the same impact and created date only the first added is
+    // kept, as the trees keep only the first one inserted.
+    // Return the number of bugs dropped that way
+    size_t orderRows(std::vector<uint32_t> (&rows)[IMPACT_COUNT]) const
+    {
+        struct Entry
+        {
+            Key key;
+            uint32_t row;
+
+            bool operator <(Entry const &rhs) const
+            {
+                return key < rhs.key || (!(rhs.key < key) && row < rhs.row);
+            }
+        };
+
+        // the key is exact, so equal keys are the same date; the text is
+        // compared as well so that only true duplicates are ever dropped
+        std::vector<Entry> entries[IMPACT_COUNT];
+        for (size_t row(0); row < keys_.size(); ++row)
+        {
+            entries[impacts_[row]].push_back(Entry{ keys_[row], static_cast<uint32_t>(row) });
+        }
+
+        size_t dropped(0);
+        for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+        {
+            std::vector<Entry> &impactEntries = entries[impact];
+            std::sort(impactEntries.begin(), impactEntries.end());
+
+            rows[impact].clear();
+            rows[impact].reserve(impactEntries.size());
+            for (size_t i(0); i < impactEntries.size(); ++i)
+            {
+                if (i > 0 && !(impactEntries[i - 1].key < impactEntries[i].key)
+                    && text(2 * impactEntries[i - 1].row + 1) == text(2 * impactEntries[i].row + 1))
+                {
+                    ++dropped;
+                    continue;
+                }
+                rows[impact].push_back(impactEntries[i].row);
+            }
+        }
+
+        return dropped;
+    }
+
+
+
+    // Queue over a list of rows, such as one impact level from orderRows
+    class Cursor
+    {
+        private:
+        BugColumns const *columns_;
+        uint32_t const *row_;
+        uint32_t const *end_;
+
+        public:
+
+        Cursor(BugColumns const *columns, std::vector<uint32_t> const &rows)
+            : columns_(columns), row_(rows.data()), end_(rows.data() + rows.size()){}
+
+        // Return true if every row has been consumed, otherwise false
+        bool empty()
+        {
+            return row_ == end_;
+        }
+
+        // Return the current row and move to the next one
+        Record popFront()
+        {
+            if (row_ == end_)
+            {
+                throw std::logic_error("BugColumns::Cursor::popFront - Cursor is empty");
+            }
+
+            return columns_->at(*row_++);
+        }
+    };
+
+    // Return a cursor over rows of this table
+    Cursor generateCursor(std::vector<uint32_t> const &rows) const
+    {
+        return Cursor(this, rows);
+    }
+
+};
+
+#endif
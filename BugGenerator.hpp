@@ -0,0 +1,196 @@
+#ifndef BUG_GENERATOR_HPP
+#define BUG_GENERATOR_HPP
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include "Bug.hpp"
+
+
+// Deterministic generator for synthetic bugs.xml exports.
+// The same settings and seed always produce byte-identical files.
+class BugGenerator
+{
+    public:
+
+    // Order of the <created> dates in the generated file
+    enum DateOrder
+    {
+        ORDER_RANDOM,       // uniformly random
+        ORDER_SORTED,       // oldest first
+        ORDER_REVERSE,      // newest first
+        ORDER_DUPLICATES    // random, but drawn from a small pool so most dates repeat
+    };
+
+    private:
+
+    uint64_t state_;
+
+    // splitmix64: small, fast and good enough for test data
+    uint64_t nextRandom()
+    {
+        uint64_t z = (state_ += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Return a random number in [0, bound)
+    uint64_t nextBelow(uint64_t bound)
+    {
+        return bound == 0 ? 0 : nextRandom() % bound;
+    }
+
+    // Map a bug index to a unique 8 hex digit id. Multiplying by an odd
+    // constant is a bijection on 32 bits, so ids never repeat.
+    static void writeId(std::string &out, uint64_t index)
+    {
+        static char const digits[] = "0123456789ABCDEF";
+        uint32_t id = static_cast<uint32_t>(index) * 0x9E3779B1u ^ 0x5A5A5A5Au;
+        for (int shift = 28; shift >= 0; shift -= 4)
+        {
+            out += digits[(id >> shift) & 0xF];
+        }
+    }
+
+    // Append a description of roughly the requested length built from a fixed vocabulary
+    void writeDescription(std::string &out, size_t length)
+    {
+        static char const * const words[] = {
+            "app", "crashes", "when", "clicking", "the", "save", "button", "login", "fails",
+            "with", "error", "page", "does", "not", "load", "on", "checkout", "cart", "total",
+            "is", "wrong", "after", "update", "image", "missing", "from", "profile", "screen" };
+        static size_t const wordCount = sizeof(words) / sizeof(words[0]);
+
+        size_t target = length / 2 + nextBelow(length + 1);
+        size_t written(0);
+        while (written < target)
+        {
+            if (written != 0)
+            {
+                out += ' ';
+                ++written;
+            }
+            char const *word = words[nextBelow(wordCount)];
+            std::string_view view(word);
+            out += view;
+            written += view.size();
+        }
+    }
+
+    public:
+
+    // Settings
+    uint64_t bugCount;
+    DateOrder order;
+    unsigned impactWeights[IMPACT_COUNT];   // relative share of high, medium and low bugs
+    size_t descriptionLength;                // average description length in characters
+    uint64_t distinctDescriptions;           // if not 0, descriptions repeat from a pool this large
+
+    // Constructor; defaults mirror the shape of the sample bugs.xml
+    BugGenerator(uint64_t seed = 1) : state_(seed), bugCount(1000), order(ORDER_RANDOM),
+        impactWeights{ 17, 13, 20 }, descriptionLength(100), distinctDescriptions(0){}
+
+    // Restart the random sequence from seed
+    void reseed(uint64_t seed)
+    {
+        state_ = seed;
+    }
+
+    // Parse a --order name. Return false if it isn't one.
+    static bool parseOrder(std::string const &name, DateOrder &order)
+    {
+        if (name == "random") { order = ORDER_RANDOM; }
+        else if (name == "sorted") { order = ORDER_SORTED; }
+        else if (name == "reverse") { order = ORDER_REVERSE; }
+        else if (name == "duplicates") { order = ORDER_DUPLICATES; }
+        else { return false; }
+
+        return true;
+    }
+
+    // Write the bugs.xml export to path.
+    // Return false if the file couldn't be written.
+    bool write(std::string const &path)
+    {
+        std::ofstream out(path, std::ofstream::binary | std::ofstream::trunc);
+        if (!out.is_open())
+        {
+            return false;
+        }
+
+        // Dates span 2015-01-01 to 2025-01-01
+        int64_t const first = daysFromCivil(2015, 1, 1) * 86400;
+        int64_t const span = daysFromCivil(2025, 1, 1) * 86400 - first;
+        uint64_t const duplicatePool = bugCount / 16 + 1;
+
+        unsigned weightTotal = impactWeights[IMPACT_HIGH] + impactWeights[IMPACT_MEDIUM] + impactWeights[IMPACT_LOW];
+        if (weightTotal == 0)
+        {
+            weightTotal = 1;
+        }
+
+        std::string chunk;
+        chunk.reserve(1 << 20);
+        chunk += "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<bugs>\n";
+
+        for (uint64_t i(0); i < bugCount; ++i)
+        {
+            int64_t offset;
+            switch (order)
+            {
+                case ORDER_SORTED:
+                    offset = static_cast<int64_t>(static_cast<double>(i) / bugCount * span);
+                    break;
+                case ORDER_REVERSE:
+                    offset = static_cast<int64_t>(static_cast<double>(bugCount - 1 - i) / bugCount * span);
+                    break;
+                case ORDER_DUPLICATES:
+                    offset = static_cast<int64_t>(nextBelow(duplicatePool) * (span / duplicatePool));
+                    break;
+                default:
+                    offset = static_cast<int64_t>(nextBelow(static_cast<uint64_t>(span)));
+                    break;
+            }
+
+            unsigned pick = static_cast<unsigned>(nextBelow(weightTotal));
+            uint8_t impact = pick < impactWeights[IMPACT_HIGH] ? IMPACT_HIGH
+                           : pick < impactWeights[IMPACT_HIGH] + impactWeights[IMPACT_MEDIUM] ? IMPACT_MEDIUM
+                           : IMPACT_LOW;
+
+            chunk += "\t<bug id=\"";
+            writeId(chunk, i);
+            chunk += "\">\n\t\t<description>";
+            if (distinctDescriptions != 0)
+            {
+                // Description n of the pool always comes from the same random sequence
+                uint64_t state = state_;
+                state_ = nextBelow(distinctDescriptions) * 0xD1B54A32D192ED03ULL;
+                writeDescription(chunk, descriptionLength);
+                state_ = state;
+            }
+            else
+            {
+                writeDescription(chunk, descriptionLength);
+            }
+            chunk += "</description>\n\t\t<impact>";
+            chunk += impactName(impact);
+            chunk += "</impact>\n\t\t<created>";
+            chunk += formatTimestamp(first + offset);
+            chunk += "</created>\n\t</bug>\n";
+
+            if (chunk.size() >= (1 << 20))
+            {
+                out.write(chunk.data(), chunk.size());
+                chunk.clear();
+            }
+        }
+
+        chunk += "</bugs>\n";
+        out.write(chunk.data(), chunk.size());
+
+        return static_cast<bool>(out);
+    }
+};
+
+#endif
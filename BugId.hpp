@@ -0,0 +1,240 @@
+#ifndef BUG_ID_HPP
+#define BUG_ID_HPP
+
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+
+// Bug id packed into an integer.
+//
+// Every id in our exports is 8 uppercase hex digits ("CAA0F1E1"); those are
+// stored as their 32-bit value, so hashing and comparing an id is integer
+// work and formatting it is a table lookup. Anything else is interned in a
+// process-wide fallback table and gets a code above 2^32, so it still
+// round-trips exactly. That table only grows, so long-running code such as
+// the server must not build ids from untrusted text; find() never interns.
+class BugId
+{
+    private:
+
+    static uint64_t const FALLBACK_BASE = uint64_t(1) << 32;
+    static uint64_t const EMPTY = ~uint64_t(0);
+
+    uint64_t code_;
+
+    // Non-conforming ids, indexed by code - FALLBACK_BASE. A deque never moves
+    // its elements, so codes can be keyed by views into names and looked up
+    // without building a string.
+    struct Fallback
+    {
+        std::mutex mutex;
+        std::deque<std::string> names;
+        std::unordered_map<std::string_view, uint64_t> codes;
+    };
+
+    static Fallback &fallback()
+    {
+        static Fallback table;
+        return table;
+    }
+
+    // Two hex digits per byte value, so an id formats four table lookups at a time
+    static constexpr std::array<char, 512> makeHexPairs()
+    {
+        std::array<char, 512> pairs = {};
+        char const digits[] = "0123456789ABCDEF";
+        for (size_t i(0); i < 256; ++i)
+        {
+            pairs[2 * i] = digits[i >> 4];
+            pairs[2 * i + 1] = digits[i & 0xF];
+        }
+        return pairs;
+    }
+
+    explicit BugId(uint64_t code) : code_(code){}
+
+    public:
+
+    // Number of characters in a canonical id
+    static size_t const WIDTH = 8;
+
+    // Parse an 8 uppercase hex digit id.
+    // Return false if text isn't in that form.
+    static bool parseHex(std::string_view text, uint32_t &value)
+    {
+        if (text.size() != WIDTH)
+        {
+            return false;
+        }
+
+        uint32_t result(0);
+        for (char c : text)
+        {
+            uint32_t digit;
+            if (c >= '0' && c <= '9')
+            {
+                digit = static_cast<uint32_t>(c - '0');
+            }
+            else if (c >= 'A' && c <= 'F')
+            {
+                digit = static_cast<uint32_t>(c - 'A' + 10);
+            }
+            else
+            {
+                return false;
+            }
+            result = result << 4 | digit;
+        }
+
+        value = result;
+        return true;
+    }
+
+    // Look up an id without interning it.
+    // Return false if text is a non-conforming id that has never been seen.
+    static bool find(std::string_view text, BugId &id)
+    {
+        uint32_t value;
+        if (parseHex(text, value))
+        {
+            id = BugId(static_cast<uint64_t>(value));
+            return true;
+        }
+        if (text.empty())
+        {
+            id = BugId();
+            return true;
+        }
+
+        Fallback &table = fallback();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto found = table.codes.find(text);
+        if (found == table.codes.end())
+        {
+            return false;
+        }
+
+        id = BugId(found->second);
+        return true;
+    }
+
+    // Constructor for an empty id
+    BugId() : code_(EMPTY){}
+
+    // Constructor from id text; non-conforming ids are interned
+    explicit BugId(std::string_view text) : code_(EMPTY)
+    {
+        uint32_t value;
+        if (parseHex(text, value))
+        {
+            code_ = value;
+            return;
+        }
+        if (text.empty())
+        {
+            return;
+        }
+
+        Fallback &table = fallback();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto found = table.codes.find(text);
+        if (found != table.codes.end())
+        {
+            code_ = found->second;
+            return;
+        }
+
+        code_ = FALLBACK_BASE + table.names.size();
+        table.names.push_back(std::string(text));
+        table.codes.emplace(std::string_view(table.names.back()), code_);
+    }
+
+    // Return the packed value: the id itself for canonical ids
+    uint64_t code() const
+    {
+        return code_;
+    }
+
+    // Return true if the id is 8 uppercase hex digits, otherwise false
+    bool canonical() const
+    {
+        return code_ < FALLBACK_BASE;
+    }
+
+    // Write a canonical id's 8 characters to out
+    void formatHex(char *out) const
+    {
+        static constexpr std::array<char, 512> pairs = makeHexPairs();
+        for (size_t i(0); i < 4; ++i)
+        {
+            size_t byte = (code_ >> (24 - 8 * i)) & 0xFF;
+            out[2 * i] = pairs[2 * byte];
+            out[2 * i + 1] = pairs[2 * byte + 1];
+        }
+    }
+
+    // Return the id text
+    std::string str() const
+    {
+        if (canonical())
+        {
+            char text[WIDTH];
+            formatHex(text);
+            return std::string(text, WIDTH);
+        }
+        if (code_ == EMPTY)
+        {
+            return std::string();
+        }
+
+        Fallback &table = fallback();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        return table.names[code_ - FALLBACK_BASE];
+    }
+
+    bool operator ==(BugId const &rhs) const
+    {
+        return code_ == rhs.code_;
+    }
+
+    bool operator !=(BugId const &rhs) const
+    {
+        return code_ != rhs.code_;
+    }
+};
+
+// Write the id text; canonical ids go out as a single 8 byte write
+inline std::ostream &operator <<(std::ostream &out, BugId const &id)
+{
+    if (id.canonical())
+    {
+        char text[BugId::WIDTH];
+        id.formatHex(text);
+        return out.write(text, BugId::WIDTH);
+    }
+
+    return out << id.str();
+}
+
+
+template <typename K> struct HashKey;
+
+// HashTable hashing for bug ids: one multiply, keeping the well-mixed high bits
+template <>
+struct HashKey<BugId>
+{
+    typedef BugId const &lookup_type;
+
+    static size_t hash(BugId const &id)
+    {
+        return static_cast<size_t>((id.code() * 0x9E3779B97F4A7C15ULL) >> 32);
+    }
+};
+
+#endif
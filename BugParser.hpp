@@ -0,0 +1,99 @@
+#ifndef BUG_PARSER_HPP
+#define BUG_PARSER_HPP
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "pugixml.hpp"
+#include "Bug.hpp"
+#include "BugColumns.hpp"
+
+
+// Reusable xml parsing state. Each thread keeps one parser so the file
+// buffer and the document's memory pages are reused from file to file.
+class BugParser
+{
+    private:
+    pugi::xml_document doc_;
+    std::vector<char> buffer_;
+
+    // Read and parse one xml bug export into doc_.
+    // Return false (after printing why) if the file can't be loaded.
+    bool parse(std::string const &path)
+    {
+        // Read the whole file into the reused buffer
+        std::ifstream inFile(path, std::ifstream::binary | std::ifstream::ate);
+        std::streamoff fileSize = inFile.is_open() ? static_cast<std::streamoff>(inFile.tellg()) : -1;
+        if (fileSize < 0)
+        {
+            std::cerr<<"Problem opening xml file \""<<path<<"\"\n";
+            return false;
+        }
+
+        buffer_.resize(static_cast<size_t>(fileSize));
+        inFile.seekg(0);
+        if (!inFile.read(buffer_.data(), fileSize))
+        {
+            std::cerr<<"Problem reading xml file \""<<path<<"\"\n";
+            return false;
+        }
+
+        // Parse in place; the document only lives until the bugs are copied out
+        if (!doc_.load_buffer_inplace(buffer_.data(), buffer_.size()))
+        {
+            std::cerr<<"Problem parsing xml file \""<<path<<"\"\n";
+            return false;
+        }
+
+        return true;
+    }
+
+    public:
+
+    // Parse one xml bug export and append its bugs in document order.
+    // Return false (after printing why) if the file can't be loaded.
+    bool load(std::string const &path, std::vector<Bug> &bugs)
+    {
+        if (!parse(path))
+        {
+            return false;
+        }
+
+        // The root element of a bug export is the <bugs> element
+        pugi::xml_node root = doc_.first_child();
+
+        // Loop over all <bug> element children of the root element
+        for (pugi::xml_node bugnode : root.children("bug"))
+        {
+            BugId id(bugnode.attribute("id").as_string());
+            std::string description = bugnode.child_value("description");
+            std::string_view impact = bugnode.child_value("impact");
+            std::string_view date = bugnode.child_value("created");
+            bugs.push_back(Bug(id, description, impact, date));
+        }
+
+        return true;
+    }
+
+    // Same as load(path, bugs), appending the bugs to a columnar table.
+    // Their text is copied straight from the document into the table's blob.
+    bool load(std::string const &path, BugColumns &bugs)
+    {
+        if (!parse(path))
+        {
+            return false;
+        }
+
+        for (pugi::xml_node bugnode : doc_.first_child().children("bug"))
+        {
+            bugs.add(BugId(bugnode.attribute("id").as_string()), bugnode.child_value("description"),
+                     bugnode.child_value("impact"), bugnode.child_value("created"));
+        }
+
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,497 @@
+#ifndef BUG_SERVER_HPP
+#define BUG_SERVER_HPP
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "BinarySearchTree.hpp"
+#include "HashTable.hpp"
+#include "Bug.hpp"
+#include "Report.hpp"
+
+
+// Long-running assignment server.
+//
+// Keeps one impact tree per impact level resident, plus an id table for closing
+// bugs, and answers line based requests over a Unix domain socket:
+//
+//   ASSIGN <n>                                   assign bugs to developers 1..n
+//   ADD <id> <impact> <created> <description>    add a bug ("\n" in the description is a newline)
+//   CLOSE <id>                                   drop an open bug
+//   COUNT                                        number of open high, medium and low bugs
+//   RANGE <impact> <from> <to>                   open bugs of an impact created from..to inclusive
+//   SHUTDOWN                                     stop the server
+//
+// Every response starts with a status line, "OK ..." or "ERR <reason>".
+// ASSIGN answers "OK <bytes>" followed by exactly that many bytes of
+// <report> xml; assigned bugs are removed from the server. RANGE answers
+// the same way with a <bugs> list, oldest first, and leaves the bugs open.
+// ASSIGN takes at most MAX_DEVELOPERS developers, and a client sending a
+// line longer than MAX_LINE gets "ERR" and is disconnected. ADD only takes
+// canonical 8 hex digit ids and "high", "medium" or "low" impacts, since any
+// other id or over-long impact would be interned for the life of the server.
+//
+// The server is sized for up to a few million open bugs: the id table has
+// TABLE_SIZE buckets, so at a million open bugs an ADD or CLOSE walks a chain
+// of about two entries. Past that the chains grow linearly with the open bugs.
+class BugServer
+{
+    public:
+
+    static int const MAX_DEVELOPERS = 100000;
+    static size_t const MAX_LINE = size_t(1) << 20;
+
+    private:
+
+    static size_t const TABLE_SIZE = 524287;
+
+    typedef HashTable<Bug, TABLE_SIZE, BugId> BugTable;
+
+    BinarySearchTree<Bug> bugTrees_[IMPACT_COUNT];
+    size_t bugCounts_[IMPACT_COUNT];
+    std::unique_ptr<BugTable> bugTable_;    // megabytes of buckets, so kept off the stack
+    bool running_;
+
+
+    // Oldest-first queue over one resident tree. Popping a bug
+    // removes it from the server for good.
+    class TreeQueue
+    {
+        private:
+        BugServer* server_;
+        uint8_t impact_;
+
+        public:
+
+        TreeQueue(BugServer* server, uint8_t impact) : server_(server), impact_(impact){}
+
+        // Return true if there are no open bugs of this impact, otherwise false
+        bool empty()
+        {
+            return server_->bugTrees_[impact_].empty();
+        }
+
+        // Remove and return the oldest open bug of this impact
+        Bug popFront()
+        {
+            Bug const * oldest = server_->bugTrees_[impact_].findMinimum();
+            if (oldest == nullptr)
+            {
+                throw std::logic_error("BugServer::TreeQueue::popFront - Tree is empty");
+            }
+
+            Bug bug = *oldest;
+            server_->remove(bug);
+            return bug;
+        }
+    };
+
+
+    // Remove a bug that is known to be open from its tree and the id table
+    void remove(Bug &bug)
+    {
+        uint8_t impact = impactCode(bug.getimpact());
+        bugTrees_[impact].remove(bug);
+        --bugCounts_[impact];
+        bugTable_->remove(bug.getbugid());
+    }
+
+    // Decode "\n" and "\\" escapes in an ADD description
+    static std::string unescape(std::string const &text)
+    {
+        std::string result;
+        result.reserve(text.size());
+
+        for (size_t i(0); i < text.size(); ++i)
+        {
+            if (text[i] == '\\' && i + 1 < text.size())
+            {
+                char c = text[++i];
+                result += c == 'n' ? '\n' : c;
+            }
+            else
+            {
+                result += text[i];
+            }
+        }
+
+        return result;
+    }
+
+    // A connected client: input not yet handled and responses not yet sent
+    struct Client
+    {
+        std::string input;
+        std::string output;
+        bool closing;       // read nothing more; disconnect once every whole line is answered
+    };
+
+    // Send as much of a client's output as its non-blocking socket takes.
+    // Return false if the client went away.
+    static bool flush(int fd, Client &client)
+    {
+        size_t sent(0);
+        while (sent < client.output.size())
+        {
+            ssize_t n = send(fd, client.output.data() + sent, client.output.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            {
+                break;
+            }
+            if (n <= 0)
+            {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+
+        client.output.erase(0, sent);
+        return true;
+    }
+
+    // Handle a client's complete request lines until one of its responses can't
+    // be sent straight away, so a client that doesn't read holds one response at most.
+    // Return false if the client went away.
+    bool answer(int fd, Client &client)
+    {
+        size_t lineEnd;
+        while (running_ && client.output.empty()
+               && (lineEnd = client.input.find('\n')) != std::string::npos)
+        {
+            std::string line = client.input.substr(0, lineEnd);
+            client.input.erase(0, lineEnd + 1);
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            client.output = handle(line);
+            if (!flush(fd, client))
+            {
+                return false;
+            }
+        }
+
+        if (!client.closing && client.input.find('\n') == std::string::npos && client.input.size() > MAX_LINE)
+        {
+            client.input.clear();
+            client.output += "ERR request line is longer than " + std::to_string(MAX_LINE) + " bytes\n";
+            client.closing = true;
+            return flush(fd, client);
+        }
+
+        return true;
+    }
+
+
+    public:
+
+    // Constructor
+    BugServer() : bugCounts_(), bugTable_(new BugTable()), running_(false){}
+
+    // Add an open bug.
+    // Return false if the id is already open or another bug of the same
+    // impact has the same created date, otherwise true
+    bool add(Bug bug)
+    {
+        BugId id = bug.getbugid();
+        size_t idHash = bugTable_->hash(id);
+        if (bugTable_->get(id, idHash) != nullptr)
+        {
+            return false;
+        }
+
+        uint8_t impact = impactCode(bug.getimpact());
+        if (!bugTrees_[impact].insert(bug))
+        {
+            return false;
+        }
+
+        ++bugCounts_[impact];
+        bugTable_->add(id, bug, idHash);
+        return true;
+    }
+
+    // Close the open bug with the given id.
+    // Return false if no such bug is open, otherwise true
+    bool close(std::string_view id)
+    {
+        BugId bugId;
+        if (!BugId::find(id, bugId))
+        {
+            return false;
+        }
+
+        Bug* bug = bugTable_->get(bugId);
+        if (bug == nullptr)
+        {
+            return false;
+        }
+
+        Bug closed = *bug;
+        remove(closed);
+        return true;
+    }
+
+    // Return the number of open bugs of an impact level
+    size_t count(uint8_t impact)
+    {
+        return bugCounts_[impact];
+    }
+
+    // Assign bugs to developers 1 to devCount and write the <report> for them.
+    // Assigned bugs are no longer open afterwards.
+    void assign(std::ostream &outFile, int devCount)
+    {
+        TreeQueue hiBugs(this, IMPACT_HIGH);
+        TreeQueue midBugs(this, IMPACT_MEDIUM);
+        TreeQueue loBugs(this, IMPACT_LOW);
+
+        outFile<<"<report>"<<std::endl;
+        writeDevelopers(outFile, devCount, hiBugs, midBugs, loBugs);
+        outFile<<"</report>"<<std::endl;
+    }
+
+    // Write the open bugs of an impact created between two dates, inclusive, oldest first
+    void range(std::ostream &outFile, uint8_t impact, std::string const &from, std::string const &to)
+    {
+        outFile<<"<bugs>"<<std::endl;
+
+        // Bugs order by created date alone, so date-only probes bound the range
+        BinarySearchTree<Bug>::Iterator iter = bugTrees_[impact].generateRange(Bug("", "", "", from),
+                                                                               Bug("", "", "", to));
+        for (; iter.hasNext(); iter.next())
+        {
+            Bug bug = *iter.current();
+            writeBug(outFile, bug);
+        }
+
+        outFile<<"</bugs>"<<std::endl;
+    }
+
+    // Handle a single request line and return the full response
+    std::string handle(std::string const &request)
+    {
+        std::istringstream in(request);
+        std::string command;
+        in >> command;
+
+        if (command == "ASSIGN")
+        {
+            int devCount = 0;
+            if (!(in >> devCount) || devCount < 0)
+            {
+                return "ERR ASSIGN needs a developer count\n";
+            }
+            if (devCount > MAX_DEVELOPERS)
+            {
+                return "ERR ASSIGN takes at most " + std::to_string(MAX_DEVELOPERS) + " developers\n";
+            }
+
+            std::ostringstream report;
+            assign(report, devCount);
+            std::string body = report.str();
+            return "OK " + std::to_string(body.size()) + "\n" + body;
+        }
+        else if (command == "ADD")
+        {
+            std::string id, impact, date, description;
+            int64_t seconds;
+            uint32_t idValue;
+            if (!(in >> id >> impact >> date) || !parseTimestamp(date, seconds))
+            {
+                return "ERR ADD needs <id> <impact> <created> <description>\n";
+            }
+            if (!BugId::parseHex(id, idValue))
+            {
+                return "ERR ADD needs an id of 8 uppercase hex digits\n";
+            }
+            if (impact != impactName(impactCode(impact)))
+            {
+                return "ERR ADD needs an impact of high, medium or low\n";
+            }
+
+            in.get();
+            std::getline(in, description);
+            if (!add(Bug(id, unescape(description), impact, date)))
+            {
+                return "ERR bug " + id + " is already open or duplicates a created date\n";
+            }
+
+            return "OK\n";
+        }
+        else if (command == "CLOSE")
+        {
+            std::string id;
+            if (!(in >> id))
+            {
+                return "ERR CLOSE needs an id\n";
+            }
+            if (!close(id))
+            {
+                return "ERR bug " + id + " is not open\n";
+            }
+
+            return "OK\n";
+        }
+        else if (command == "COUNT")
+        {
+            return "OK " + std::to_string(bugCounts_[IMPACT_HIGH]) + " " + std::to_string(bugCounts_[IMPACT_MEDIUM])
+                 + " " + std::to_string(bugCounts_[IMPACT_LOW]) + "\n";
+        }
+        else if (command == "RANGE")
+        {
+            std::string impact, from, to;
+            int64_t seconds;
+            if (!(in >> impact >> from >> to) || impact != impactName(impactCode(impact))
+                || !parseTimestamp(from, seconds) || !parseTimestamp(to, seconds))
+            {
+                return "ERR RANGE needs <impact> <from> <to>\n";
+            }
+
+            std::ostringstream bugs;
+            range(bugs, impactCode(impact), from, to);
+            std::string body = bugs.str();
+            return "OK " + std::to_string(body.size()) + "\n" + body;
+        }
+        else if (command == "SHUTDOWN")
+        {
+            running_ = false;
+            return "OK\n";
+        }
+
+        return "ERR unknown command \"" + command + "\"\n";
+    }
+
+    // Listen on a Unix domain socket and answer requests until SHUTDOWN.
+    // Clients are served one request at a time from a single poll loop, so the
+    // trees never need locking. Client sockets are non-blocking and a response
+    // a client doesn't read yet waits in its output until poll says it can be
+    // sent, so one slow client never holds up the others.
+    // Return false if the socket couldn't be set up.
+    bool serve(char const *socketPath)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (std::strlen(socketPath) >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        std::strcpy(address.sun_path, socketPath);
+
+        int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listenFd < 0)
+        {
+            return false;
+        }
+
+        unlink(socketPath);
+        if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0
+            || listen(listenFd, SOMAXCONN) != 0)
+        {
+            ::close(listenFd);
+            return false;
+        }
+
+        // Slot 0 is the listening socket, the rest are clients
+        std::vector<pollfd> fds(1, pollfd{ listenFd, POLLIN, 0 });
+        std::vector<Client> clients(1);
+
+        running_ = true;
+        while (running_)
+        {
+            if (poll(fds.data(), fds.size(), -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+
+            for (size_t i(fds.size() - 1); i > 0 && running_; --i)
+            {
+                if (fds[i].revents == 0)
+                {
+                    continue;
+                }
+
+                Client &client = clients[i];
+                bool connected = !(fds[i].revents & (POLLERR | POLLNVAL));
+                if (connected && !client.output.empty())
+                {
+                    connected = flush(fds[i].fd, client);
+                }
+                else if (connected && (fds[i].revents & (POLLIN | POLLHUP)))
+                {
+                    char buffer[4096];
+                    ssize_t n = read(fds[i].fd, buffer, sizeof(buffer));
+                    connected = n >= 0 || errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK;
+                    if (n > 0)
+                    {
+                        client.input.append(buffer, static_cast<size_t>(n));
+                    }
+                    else if (n == 0)
+                    {
+                        // the client is done sending, but still gets its answers
+                        client.closing = true;
+                    }
+                }
+
+                if (connected && client.output.empty())
+                {
+                    connected = answer(fds[i].fd, client);
+                }
+
+                if (!connected || (client.closing && client.output.empty()))
+                {
+                    ::close(fds[i].fd);
+                    fds.erase(fds.begin() + i);
+                    clients.erase(clients.begin() + i);
+                    continue;
+                }
+
+                // wait to send the rest of a response before reading the next request
+                fds[i].events = client.output.empty() ? POLLIN : POLLOUT;
+            }
+
+            if (fds[0].revents & POLLIN)
+            {
+                int client = accept(listenFd, nullptr, nullptr);
+                if (client >= 0 && fcntl(client, F_SETFL, fcntl(client, F_GETFL) | O_NONBLOCK) == 0)
+                {
+                    fds.push_back(pollfd{ client, POLLIN, 0 });
+                    clients.push_back(Client{ std::string(), std::string(), false });
+                }
+                else if (client >= 0)
+                {
+                    ::close(client);
+                }
+            }
+        }
+
+        for (pollfd &fd : fds)
+        {
+            ::close(fd.fd);
+        }
+        unlink(socketPath);
+
+        return true;
+    }
+
+};
+
+#endif
@@ -0,0 +1,387 @@
+#ifndef BUG_STORE_HPP
+#define BUG_STORE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Bug.hpp"
+
+
+// Binary columnar bug store.
+//
+// A store holds every bug of an imported bugs.xml in fixed-width columns so it
+// can be mmapped and read in place at startup instead of re-parsing the XML:
+//
+//   Header                        magic, version, row count, blob size, impact ranges
+//   ids      [count][ID_WIDTH]    bug ids, zero padded
+//   keys     [count] int64        <created> as seconds since the Unix epoch
+//   impacts  [count] uint8        impact level (padded to a multiple of 8 bytes)
+//   offsets  [count + 1] uint64   start of each description in the blob
+//   blob     [blobSize] char      description text, back to back
+//
+// Rows are grouped by impact and sorted oldest first inside each group, and
+// duplicate timestamps are dropped the same way BinarySearchTree::insert drops
+// them, so the report can be produced straight from the mapped columns.
+namespace BugStoreFormat
+{
+    static size_t const ID_WIDTH = 16;
+    static uint32_t const VERSION = 1;
+    static char const MAGIC[4] = { 'P', 'C', 'B', 'S' };
+
+    struct Header
+    {
+        char magic[4];
+        uint32_t version;
+        uint64_t count;
+        uint64_t blobSize;
+        uint64_t impactBegin[IMPACT_COUNT + 1];
+    };
+
+    // Round up to the next multiple of 8 so every column stays aligned
+    inline uint64_t pad(uint64_t bytes)
+    {
+        return (bytes + 7) & ~uint64_t(7);
+    }
+
+    // Work out the total file size of a store with the given row count and blob size.
+    // Return false if it doesn't fit in 64 bits.
+    inline bool fileSize(uint64_t count, uint64_t blobSize, uint64_t &size)
+    {
+        // ids, keys, impacts and offsets take under 40 bytes a row, plus one offset and padding
+        if (count > (UINT64_MAX - sizeof(Header) - 16) / (ID_WIDTH + 2 * sizeof(uint64_t) + 8))
+        {
+            return false;
+        }
+
+        size = sizeof(Header) + count * ID_WIDTH + count * sizeof(int64_t)
+             + pad(count) + (count + 1) * sizeof(uint64_t);
+        if (blobSize > UINT64_MAX - size)
+        {
+            return false;
+        }
+
+        size += blobSize;
+        return true;
+    }
+}
+
+
+// Collects parsed bugs and writes them out as a store file
+class BugStoreWriter
+{
+    private:
+
+    struct Row
+    {
+        std::string id;
+        int64_t key;
+        uint8_t impact;
+        std::string description;
+    };
+
+    std::vector<Row> rows_;
+
+    public:
+
+    // Add a bug to the store.
+    // Return false if the id is too long, the impact isn't "high", "medium" or "low"
+    // or the date is malformed, since the store only keeps the impact level and
+    // the parsed timestamp and couldn't give back the original text.
+    bool add(std::string const &id, std::string const &description, std::string const &impact, std::string const &date)
+    {
+        int64_t key;
+        uint8_t level = impactCode(impact);
+        if (id.size() > BugStoreFormat::ID_WIDTH || impact != impactName(level) || !parseTimestamp(date, key))
+        {
+            return false;
+        }
+
+        rows_.push_back(Row{ id, key, level, description });
+        return true;
+    }
+
+    // Write all added bugs to path.
+    // Return false if the file couldn't be written.
+    bool save(char const *path)
+    {
+        using namespace BugStoreFormat;
+
+        // Stable sort keeps the first of several equal timestamps in front, matching the trees
+        std::stable_sort(rows_.begin(), rows_.end(), [](Row const &a, Row const &b)
+        {
+            return a.impact != b.impact ? a.impact < b.impact : a.key < b.key;
+        });
+        rows_.erase(std::unique(rows_.begin(), rows_.end(), [](Row const &a, Row const &b)
+        {
+            return a.impact == b.impact && a.key == b.key;
+        }), rows_.end());
+
+        Header header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.count = rows_.size();
+        header.blobSize = 0;
+        for (Row const &row : rows_)
+        {
+            header.blobSize += row.description.size();
+        }
+        for (size_t impact(0), row(0); impact <= IMPACT_COUNT; ++impact)
+        {
+            while (row < rows_.size() && rows_[row].impact < impact)
+            {
+                ++row;
+            }
+            header.impactBegin[impact] = impact == IMPACT_COUNT ? rows_.size() : row;
+        }
+
+        std::ofstream out(path, std::ofstream::binary | std::ofstream::trunc);
+        if (!out.is_open())
+        {
+            return false;
+        }
+
+        out.write(reinterpret_cast<char const *>(&header), sizeof(header));
+
+        char id[ID_WIDTH];
+        for (Row const &row : rows_)
+        {
+            std::memset(id, 0, ID_WIDTH);
+            std::memcpy(id, row.id.data(), row.id.size());
+            out.write(id, ID_WIDTH);
+        }
+
+        for (Row const &row : rows_)
+        {
+            out.write(reinterpret_cast<char const *>(&row.key), sizeof(row.key));
+        }
+
+        for (Row const &row : rows_)
+        {
+            out.put(static_cast<char>(row.impact));
+        }
+        for (uint64_t i(rows_.size()); i < pad(rows_.size()); ++i)
+        {
+            out.put('\0');
+        }
+
+        uint64_t offset(0);
+        for (Row const &row : rows_)
+        {
+            out.write(reinterpret_cast<char const *>(&offset), sizeof(offset));
+            offset += row.description.size();
+        }
+        out.write(reinterpret_cast<char const *>(&offset), sizeof(offset));
+
+        for (Row const &row : rows_)
+        {
+            out.write(row.description.data(), row.description.size());
+        }
+
+        return static_cast<bool>(out);
+    }
+};
+
+
+// Read-only, memory mapped view of a store file
+class BugStore
+{
+    private:
+
+    void *map_;
+    size_t mapSize_;
+    BugStoreFormat::Header const *header_;
+    char const *ids_;
+    int64_t const *keys_;
+    uint8_t const *impacts_;
+    uint64_t const *offsets_;
+    char const *blob_;
+
+    public:
+
+    // A single bug, pointing into the mapped columns
+    struct Record
+    {
+        std::string_view id;
+        std::string_view description;
+        uint8_t impact;
+        int64_t key;
+    };
+
+    // Constructor
+    BugStore() : map_(nullptr), mapSize_(0), header_(nullptr), ids_(nullptr), keys_(nullptr),
+        impacts_(nullptr), offsets_(nullptr), blob_(nullptr){}
+
+    // Mapped stores can't be copied
+    BugStore(BugStore const &) = delete;
+    BugStore &operator =(BugStore const &) = delete;
+
+    // Map the store at path.
+    // Return false if the file can't be mapped or isn't a valid store.
+    bool open(char const *path)
+    {
+        using namespace BugStoreFormat;
+
+        close();
+
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0)
+        {
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(Header))
+        {
+            ::close(fd);
+            return false;
+        }
+
+        mapSize_ = static_cast<size_t>(info.st_size);
+        map_ = mmap(nullptr, mapSize_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (map_ == MAP_FAILED)
+        {
+            map_ = nullptr;
+            mapSize_ = 0;
+            return false;
+        }
+
+        header_ = static_cast<Header const *>(map_);
+        uint64_t size;
+        if (std::memcmp(header_->magic, MAGIC, sizeof(MAGIC)) != 0 || header_->version != VERSION
+            || !fileSize(header_->count, header_->blobSize, size) || size != mapSize_)
+        {
+            close();
+            return false;
+        }
+
+        uint64_t count = header_->count;
+        char const *base = static_cast<char const *>(map_);
+        ids_ = base + sizeof(Header);
+        keys_ = reinterpret_cast<int64_t const *>(ids_ + count * ID_WIDTH);
+        impacts_ = reinterpret_cast<uint8_t const *>(keys_ + count);
+        offsets_ = reinterpret_cast<uint64_t const *>(impacts_ + pad(count));
+        blob_ = reinterpret_cast<char const *>(offsets_ + count + 1);
+
+        bool valid = offsets_[0] == 0 && offsets_[count] == header_->blobSize && header_->impactBegin[0] == 0
+                  && header_->impactBegin[IMPACT_COUNT] == count;
+        for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+        {
+            valid = valid && header_->impactBegin[impact] <= header_->impactBegin[impact + 1];
+        }
+
+        // every description must lie inside the blob, so at() never reads past the mapping
+        for (uint64_t row(0); valid && row < count; ++row)
+        {
+            valid = offsets_[row] <= offsets_[row + 1] && impacts_[row] < IMPACT_COUNT;
+        }
+        if (!valid)
+        {
+            close();
+            return false;
+        }
+
+        return true;
+    }
+
+    // Unmap the store
+    void close()
+    {
+        if (map_ != nullptr)
+        {
+            munmap(map_, mapSize_);
+        }
+
+        map_ = nullptr;
+        mapSize_ = 0;
+        header_ = nullptr;
+        ids_ = nullptr;
+        keys_ = nullptr;
+        impacts_ = nullptr;
+        offsets_ = nullptr;
+        blob_ = nullptr;
+    }
+
+    // Destructor
+    ~BugStore()
+    {
+        close();
+    }
+
+    // Return the number of bugs in the store
+    size_t size() const
+    {
+        return header_ != nullptr ? header_->count : 0;
+    }
+
+    // Return the first row of an impact group
+    size_t impactBegin(uint8_t impact) const
+    {
+        return header_->impactBegin[impact];
+    }
+
+    // Return one past the last row of an impact group
+    size_t impactEnd(uint8_t impact) const
+    {
+        return header_->impactBegin[impact + 1];
+    }
+
+    // Return the bug stored at row
+    Record at(size_t row) const
+    {
+        char const *id = ids_ + row * BugStoreFormat::ID_WIDTH;
+        return Record{ std::string_view(id, strnlen(id, BugStoreFormat::ID_WIDTH)),
+                       std::string_view(blob_ + offsets_[row], offsets_[row + 1] - offsets_[row]),
+                       impacts_[row], keys_[row] };
+    }
+
+
+
+    // Oldest-first queue over the rows of one impact group
+    class Cursor
+    {
+        private:
+        BugStore const *store_;
+        size_t row_;
+        size_t end_;
+
+        public:
+
+        Cursor(BugStore const *store, size_t begin, size_t end) : store_(store), row_(begin), end_(end){}
+
+        // Return true if every row has been consumed, otherwise false
+        bool empty()
+        {
+            return row_ >= end_;
+        }
+
+        // Return the current row and move to the next one
+        Record popFront()
+        {
+            if (row_ >= end_)
+            {
+                throw std::logic_error("BugStore::Cursor::popFront - Cursor is empty");
+            }
+
+            return store_->at(row_++);
+        }
+    };
+
+    // Return a cursor over all bugs of an impact level, oldest first
+    Cursor generateCursor(uint8_t impact) const
+    {
+        return Cursor(this, impactBegin(impact), impactEnd(impact));
+    }
+
+};
+
+#endif
@@ -0,0 +1,494 @@
+/***************************************
+Pest Control Container Benchmark
+Description: Micro-benchmarks for the LinkedList,
+BinarySearchTree, BTree, FrozenTree, MinHeap and HashTable templates across sizes
+and key distributions, printed as CSV or JSON so runs
+from different builds can be compared.
+Build: g++ -std=c++17 -O2 ContainerBenchmark.cpp -o container-benchmark
+Usage: run with --help for the command line options.
+***************************************/
+
+
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "LinkedList.hpp"
+#include "BinarySearchTree.hpp"
+#include "BTree.hpp"
+#include "FrozenTree.hpp"
+#include "MinHeap.hpp"
+#include "HashTable.hpp"
+#include "BugId.hpp"
+using namespace std;
+
+
+// One timed operation
+struct Measurement {
+    string container;
+    string operation;
+    string distribution;
+    size_t size;
+    size_t operations;
+    double nanoseconds;    // best total time over all repeats
+};
+
+// Keeps results alive so the compiler can't drop the work being timed
+volatile uint64_t sink = 0;
+
+// splitmix64, so every run benchmarks the same keys
+uint64_t nextRandom(uint64_t &state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Return size distinct keys in the given order: random, sorted or reverse
+vector<long long> makeKeys(string const &distribution, size_t size) {
+    vector<long long> keys(size);
+    for (size_t i = 0; i < size; i++) {
+        keys[i] = static_cast<long long>(i) * 7919;
+    };
+
+    if (distribution == "random") {
+        uint64_t state = size;
+        for (size_t i = size; i > 1; i--) {
+            swap(keys[i - 1], keys[nextRandom(state) % i]);
+        };
+    } else if (distribution == "reverse") {
+        reverse(keys.begin(), keys.end());
+    };
+
+    return keys;
+}
+
+// Format a key as an 8 hex digit id, like the ids in bugs.xml
+string makeId(long long key) {
+    static char const digits[] = "0123456789ABCDEF";
+    string id(8, '0');
+    uint32_t value = static_cast<uint32_t>(key);
+    for (int i = 7; i >= 0; i--) {
+        id[i] = digits[value & 0xF];
+        value >>= 4;
+    };
+    return id;
+}
+
+// Time run(state) after an untimed setup() and keep the best of repeat runs
+template <typename Setup, typename Run>
+void measure(vector<Measurement> &results, string const &container, string const &operation,
+             string const &distribution, size_t size, size_t operations, int repeat, Setup setup, Run run) {
+
+    double best = numeric_limits<double>::max();
+    for (int r = 0; r < repeat; r++) {
+        auto state = setup();
+        auto start = chrono::steady_clock::now();
+        run(*state);
+        auto stop = chrono::steady_clock::now();
+        best = min(best, chrono::duration<double, nano>(stop - start).count());
+    };
+
+    results.push_back(Measurement{ container, operation, distribution, size, operations, best });
+}
+
+void benchmarkLinkedList(vector<Measurement> &results, string const &distribution, size_t size, int repeat) {
+    vector<long long> keys = makeKeys(distribution, size);
+    typedef LinkedList<long long> List;
+
+    auto empty = [&]() { return unique_ptr<List>(new List()); };
+    auto filled = [&]() {
+        unique_ptr<List> list(new List());
+        for (long long key : keys) {
+            list->pushFront(key);
+        };
+        return list;
+    };
+
+    measure(results, "LinkedList", "pushFront", distribution, size, size, repeat, empty, [&](List &list) {
+        for (long long key : keys) {
+            list.pushFront(key);
+        };
+    });
+
+    measure(results, "LinkedList", "pushBack", distribution, size, size, repeat, empty, [&](List &list) {
+        for (long long key : keys) {
+            list.pushBack(key);
+        };
+    });
+
+    measure(results, "LinkedList", "popFront", distribution, size, size, repeat, filled, [&](List &list) {
+        uint64_t sum = 0;
+        while (!list.empty()) {
+            sum += list.popFront();
+        };
+        sink = sink + sum;
+    });
+
+    // Probe a fixed number of positions spread over the list
+    size_t probes = min<size_t>(size, 1000);
+    measure(results, "LinkedList", "at", distribution, size, probes, repeat, filled, [&](List &list) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < probes; i++) {
+            sum += list.at(keys[i] % size);
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, "LinkedList", "rangeFor", distribution, size, size, repeat, filled, [&](List &list) {
+        uint64_t sum = 0;
+        for (long long key : list) {
+            sum += key;
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, "LinkedList", "size", distribution, size, 100, repeat, filled, [&](List &list) {
+        uint64_t sum = 0;
+        for (int i = 0; i < 100; i++) {
+            sum += list.size();
+        };
+        sink = sink + sum;
+    });
+}
+
+// Ordered containers share an interface, so BinarySearchTree and BTree run the same operations
+template <typename Tree>
+void benchmarkTree(vector<Measurement> &results, string const &name, string const &distribution, size_t size,
+                   int repeat) {
+    vector<long long> keys = makeKeys(distribution, size);
+
+    auto empty = [&]() { return unique_ptr<Tree>(new Tree()); };
+    auto filled = [&]() {
+        unique_ptr<Tree> tree(new Tree());
+        for (long long key : keys) {
+            tree->insert(key);
+        };
+        return tree;
+    };
+
+    measure(results, name, "insert", distribution, size, size, repeat, empty, [&](Tree &tree) {
+        for (long long key : keys) {
+            tree.insert(key);
+        };
+    });
+
+    measure(results, name, "remove", distribution, size, size, repeat, filled, [&](Tree &tree) {
+        for (long long key : keys) {
+            tree.remove(key);
+        };
+    });
+
+    measure(results, name, "findMinimum", distribution, size, 1000, repeat, filled, [&](Tree &tree) {
+        uint64_t sum = 0;
+        for (int i = 0; i < 1000; i++) {
+            sum += *tree.findMinimum();
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, name, "getSortedList", distribution, size, size, repeat, filled, [&](Tree &tree) {
+        LinkedList<long long> sorted = tree.getSortedList();
+        sink = sink + sorted.empty();
+    });
+
+    measure(results, name, "Iterator", distribution, size, size, repeat, filled, [&](Tree &tree) {
+        uint64_t sum = 0;
+        for (typename Tree::Iterator iter = tree.generateIterator(); iter.hasNext(); iter.next()) {
+            sum += *iter.current();
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, name, "rangeFor", distribution, size, size, repeat, filled, [&](Tree &tree) {
+        uint64_t sum = 0;
+        for (long long key : tree) {
+            sum += key;
+        };
+        sink = sink + sum;
+    });
+}
+
+void benchmarkFrozenTree(vector<Measurement> &results, string const &distribution, size_t size, int repeat) {
+    vector<long long> keys = makeKeys(distribution, size);
+    typedef FrozenTree<long long> Index;
+
+    BTree<long long> tree;
+    for (long long key : keys) {
+        tree.insert(key);
+    };
+
+    auto frozen = [&]() { return unique_ptr<Index>(new Index(tree.freeze())); };
+
+    measure(results, "FrozenTree", "freeze", distribution, size, size, repeat,
+            [&]() { return unique_ptr<Index>(new Index()); }, [&](Index &index) {
+        index = tree.freeze();
+    });
+
+    // Probe every key plus the gap just above it
+    measure(results, "FrozenTree", "lowerBound", distribution, size, 2 * size, repeat, frozen, [&](Index &index) {
+        uint64_t sum = 0;
+        for (long long key : keys) {
+            sum += index.lowerBound(key) + index.lowerBound(key + 1);
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, "FrozenTree", "Iterator", distribution, size, size, repeat, frozen, [&](Index &index) {
+        uint64_t sum = 0;
+        for (Index::Iterator iter = index.generateIterator(); iter.hasNext(); iter.next()) {
+            sum += *iter.current();
+        };
+        sink = sink + sum;
+    });
+}
+
+void benchmarkMinHeap(vector<Measurement> &results, string const &distribution, size_t size, int repeat) {
+    vector<long long> keys = makeKeys(distribution, size);
+    typedef MinHeap<long long> Heap;
+
+    auto empty = [&]() { return unique_ptr<Heap>(new Heap()); };
+    auto filled = [&]() {
+        unique_ptr<Heap> heap(new Heap());
+        heap->heapify(keys);
+        return heap;
+    };
+
+    measure(results, "MinHeap", "push", distribution, size, size, repeat, empty, [&](Heap &heap) {
+        for (long long key : keys) {
+            heap.push(key);
+        };
+    });
+
+    measure(results, "MinHeap", "heapify", distribution, size, size, repeat, empty, [&](Heap &heap) {
+        heap.heapify(keys);
+    });
+
+    measure(results, "MinHeap", "popMinimum", distribution, size, size, repeat, filled, [&](Heap &heap) {
+        uint64_t sum = 0;
+        while (!heap.empty()) {
+            sum += heap.popMinimum();
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, "MinHeap", "findMinimum", distribution, size, 1000, repeat, filled, [&](Heap &heap) {
+        uint64_t sum = 0;
+        for (int i = 0; i < 1000; i++) {
+            sum += *heap.findMinimum();
+        };
+        sink = sink + sum;
+    });
+}
+
+void benchmarkHashTable(vector<Measurement> &results, string const &distribution, size_t size, int repeat) {
+    vector<long long> keys = makeKeys(distribution, size);
+    vector<string> ids;
+    for (long long key : keys) {
+        ids.push_back(makeId(key));
+    };
+    typedef HashTable<long long, 1031> Table;
+
+    auto empty = [&]() { return unique_ptr<Table>(new Table()); };
+    auto filled = [&]() {
+        unique_ptr<Table> table(new Table());
+        for (size_t i = 0; i < size; i++) {
+            table->add(ids[i], keys[i]);
+        };
+        return table;
+    };
+
+    measure(results, "HashTable", "add", distribution, size, size, repeat, empty, [&](Table &table) {
+        for (size_t i = 0; i < size; i++) {
+            table.add(ids[i], keys[i]);
+        };
+    });
+
+    measure(results, "HashTable", "get", distribution, size, size, repeat, filled, [&](Table &table) {
+        uint64_t sum = 0;
+        for (string const &id : ids) {
+            sum += *table.get(id);
+        };
+        sink = sink + sum;
+    });
+
+    // Raw id characters with hashes computed up front, as a parser holding
+    // attribute pointers would look them up
+    vector<size_t> hashes;
+    for (string const &id : ids) {
+        hashes.push_back(Table::hash(id));
+    };
+    measure(results, "HashTable", "getPrehashed", distribution, size, size, repeat, filled, [&](Table &table) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < size; i++) {
+            sum += *table.get(ids[i].c_str(), hashes[i]);
+        };
+        sink = sink + sum;
+    });
+
+    // The same ids parsed into integer keys, hashed with a single multiply
+    typedef HashTable<long long, 1031, BugId> IdTable;
+    vector<BugId> bugIds;
+    for (string const &id : ids) {
+        bugIds.push_back(BugId(id));
+    };
+    auto emptyIds = [&]() { return unique_ptr<IdTable>(new IdTable()); };
+    auto filledIds = [&]() {
+        unique_ptr<IdTable> table(new IdTable());
+        for (size_t i = 0; i < size; i++) {
+            table->add(bugIds[i], keys[i]);
+        };
+        return table;
+    };
+
+    measure(results, "HashTable", "addBugId", distribution, size, size, repeat, emptyIds, [&](IdTable &table) {
+        for (size_t i = 0; i < size; i++) {
+            table.add(bugIds[i], keys[i]);
+        };
+    });
+
+    measure(results, "HashTable", "getBugId", distribution, size, size, repeat, filledIds, [&](IdTable &table) {
+        uint64_t sum = 0;
+        for (BugId const &id : bugIds) {
+            sum += *table.get(id);
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, "HashTable", "remove", distribution, size, size, repeat, filled, [&](Table &table) {
+        for (string const &id : ids) {
+            table.remove(id);
+        };
+    });
+
+    measure(results, "HashTable", "Iterator", distribution, size, size, repeat, filled, [&](Table &table) {
+        uint64_t sum = 0;
+        for (Table::Iterator iter = table.generateIterator(); iter.hasNext(); iter.next()) {
+            sum += iter.current()->second;
+        };
+        sink = sink + sum;
+    });
+
+    measure(results, "HashTable", "rangeFor", distribution, size, size, repeat, filled, [&](Table &table) {
+        uint64_t sum = 0;
+        for (pair<string, long long> const &entry : table) {
+            sum += entry.second;
+        };
+        sink = sink + sum;
+    });
+}
+
+// Split a comma separated option value
+vector<string> splitList(string const &text) {
+    vector<string> items;
+    stringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        };
+    };
+    return items;
+}
+
+void printUsage(ostream &out, char const *program) {
+    out<<"Usage: "<<program<<" [options]\n"
+       <<"      --containers <list>        LinkedList,BinarySearchTree,BTree,FrozenTree,\n"
+       <<"                                 MinHeap,HashTable (default all)\n"
+       <<"      --sizes <list>             element counts (default 1000,10000)\n"
+       <<"      --distributions <list>     random,sorted,reverse (default all)\n"
+       <<"  -r, --repeat <n>               keep the best of n runs (default 3)\n"
+       <<"      --json                     print a JSON array instead of CSV\n"
+       <<"  -h, --help                     show this message\n"
+       <<"Sorted and reverse keys turn the unbalanced BST into a list, and LinkedList::pushBack\n"
+       <<"is linear per call, so large sizes take quadratic time there.\n";
+}
+
+int main(int argc, char *argv[]) {
+
+    vector<string> containers = { "LinkedList", "BinarySearchTree", "BTree", "FrozenTree", "MinHeap", "HashTable" };
+    vector<string> sizes = { "1000", "10000" };
+    vector<string> distributions = { "random", "sorted", "reverse" };
+    int repeat = 3;
+    bool json = false;
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "-h" || arg == "--help") {
+            printUsage(cout, argv[0]);
+            return 0;
+        } else if (arg == "--containers" && hasValue) {
+            containers = splitList(argv[++i]);
+        } else if (arg == "--sizes" && hasValue) {
+            sizes = splitList(argv[++i]);
+        } else if (arg == "--distributions" && hasValue) {
+            distributions = splitList(argv[++i]);
+        } else if ((arg == "-r" || arg == "--repeat") && hasValue) {
+            repeat = max(1, atoi(argv[++i]));
+        } else if (arg == "--json") {
+            json = true;
+        } else {
+            cerr<<"Unknown or incomplete option \""<<arg<<"\"\n";
+            printUsage(cerr, argv[0]);
+            return 1;
+        };
+    };
+
+    vector<Measurement> results;
+
+    for (string const &container : containers) {
+        for (string const &distribution : distributions) {
+            for (string const &sizeText : sizes) {
+                size_t size = strtoull(sizeText.c_str(), nullptr, 10);
+                if (size == 0) {
+                    continue;
+                };
+
+                if (container == "LinkedList") {
+                    benchmarkLinkedList(results, distribution, size, repeat);
+                } else if (container == "BinarySearchTree") {
+                    benchmarkTree<BinarySearchTree<long long>>(results, container, distribution, size, repeat);
+                } else if (container == "BTree") {
+                    benchmarkTree<BTree<long long>>(results, container, distribution, size, repeat);
+                } else if (container == "FrozenTree") {
+                    benchmarkFrozenTree(results, distribution, size, repeat);
+                } else if (container == "MinHeap") {
+                    benchmarkMinHeap(results, distribution, size, repeat);
+                } else if (container == "HashTable") {
+                    benchmarkHashTable(results, distribution, size, repeat);
+                } else {
+                    cerr<<"Unknown container \""<<container<<"\"\n";
+                    return 1;
+                };
+            };
+        };
+    };
+
+    if (json) {
+        cout<<"["<<endl;
+        for (size_t i = 0; i < results.size(); i++) {
+            Measurement const &m = results[i];
+            cout<<"  {\"container\":\""<<m.container<<"\",\"operation\":\""<<m.operation
+                <<"\",\"distribution\":\""<<m.distribution<<"\",\"size\":"<<m.size
+                <<",\"operations\":"<<m.operations<<",\"ns\":"<<m.nanoseconds
+                <<",\"ns_per_op\":"<<m.nanoseconds / m.operations<<"}"<<(i + 1 < results.size() ? "," : "")<<endl;
+        };
+        cout<<"]"<<endl;
+    } else {
+        cout<<"container,operation,distribution,size,operations,ns,ns_per_op"<<endl;
+        for (Measurement const &m : results) {
+            cout<<m.container<<","<<m.operation<<","<<m.distribution<<","<<m.size<<","
+                <<m.operations<<","<<m.nanoseconds<<","<<m.nanoseconds / m.operations<<endl;
+        };
+    };
+
+    return 0;
+}
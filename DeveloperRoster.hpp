@@ -0,0 +1,258 @@
+#ifndef DEVELOPER_ROSTER_HPP
+#define DEVELOPER_ROSTER_HPP
+
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "pugixml.hpp"
+#include "Bug.hpp"
+
+
+// The developers bugs are assigned to, in assignment order, as one compact
+// table: every id back to back in a single blob, plus a capacity and a mask
+// of the impact levels each developer may take.
+//
+// A roster is either numbered, developers "1" to count with no capacity
+// limit taking every impact level, which stores nothing per developer, or
+// loaded from a file:
+//
+//   <developers>
+//     <developer id="ada" capacity="4" impacts="high medium"/>
+//   </developers>
+//
+// or, for a path ending in .csv, one "id,capacity,impacts" line per developer
+// with an optional header line. A missing capacity means no limit and
+// missing impacts mean every level.
+class DeveloperRoster
+{
+    public:
+
+    static uint8_t const ALL_IMPACTS = (1 << IMPACT_COUNT) - 1;
+
+    private:
+
+    size_t count_;
+    std::vector<uint32_t> idEnds_;      // end of each id in ids_, empty when numbered
+    std::vector<char> ids_;
+    std::vector<unsigned> capacities_;
+    std::vector<uint8_t> impacts_;      // bit i set if the developer takes impact level i
+
+    // Parse a capacity, empty for no limit.
+    // Return false if text isn't a count.
+    static bool parseCapacity(std::string_view text, unsigned &capacity)
+    {
+        if (text.empty())
+        {
+            capacity = UINT_MAX;
+            return true;
+        }
+
+        std::string digits(text);
+        char *end = nullptr;
+        unsigned long value = std::strtoul(digits.c_str(), &end, 10);
+        if (digits[0] == '-' || *end != '\0' || value > UINT_MAX)
+        {
+            return false;
+        }
+
+        capacity = static_cast<unsigned>(value);
+        return true;
+    }
+
+    // Parse a space separated list of impact names, empty for every level.
+    // Return false if a name isn't "high", "medium" or "low".
+    static bool parseImpacts(std::string_view text, uint8_t &impacts)
+    {
+        impacts = 0;
+        while (!text.empty())
+        {
+            size_t end = text.find(' ');
+            std::string_view name = text.substr(0, end);
+            text = end == std::string_view::npos ? std::string_view() : text.substr(end + 1);
+            if (name.empty())
+            {
+                continue;
+            }
+
+            uint8_t impact = impactCode(name);
+            if (name != impactName(impact))
+            {
+                return false;
+            }
+            impacts |= 1 << impact;
+        }
+
+        if (impacts == 0)
+        {
+            impacts = ALL_IMPACTS;
+        }
+        return true;
+    }
+
+    // Add a developer from the text of its fields.
+    // Return false (after printing why) if a field is malformed.
+    bool addFields(std::string const &path, std::string_view id, std::string_view capacity, std::string_view impacts)
+    {
+        unsigned capacityValue;
+        uint8_t impactMask;
+        if (id.empty() || !parseCapacity(capacity, capacityValue) || !parseImpacts(impacts, impactMask))
+        {
+            std::cerr<<"Invalid developer \""<<id<<"\" in roster \""<<path<<"\"\n";
+            return false;
+        }
+
+        add(id, capacityValue, impactMask);
+        return true;
+    }
+
+    // Load a roster of <developer> elements
+    bool loadXml(std::string const &path)
+    {
+        pugi::xml_document doc;
+        if (!doc.load_file(path.c_str()))
+        {
+            std::cerr<<"Problem parsing roster \""<<path<<"\"\n";
+            return false;
+        }
+
+        for (pugi::xml_node developer : doc.first_child().children("developer"))
+        {
+            if (!addFields(path, developer.attribute("id").as_string(), developer.attribute("capacity").as_string(),
+                           developer.attribute("impacts").as_string()))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Load a roster of "id,capacity,impacts" lines
+    bool loadCsv(std::string const &path)
+    {
+        std::ifstream inFile(path);
+        if (!inFile.is_open())
+        {
+            std::cerr<<"Problem opening roster \""<<path<<"\"\n";
+            return false;
+        }
+
+        std::string line;
+        bool first(true);
+        while (std::getline(inFile, line))
+        {
+            if (!line.empty() && line.back() == '\r')
+            {
+                line.pop_back();
+            }
+
+            std::string_view fields[3];
+            std::string_view rest(line);
+            for (std::string_view &field : fields)
+            {
+                size_t end = rest.find(',');
+                field = rest.substr(0, end);
+                rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+            }
+
+            if (first && fields[0] == "id")
+            {
+                first = false;
+                continue;
+            }
+            first = false;
+
+            if (line.empty())
+            {
+                continue;
+            }
+            if (!addFields(path, fields[0], fields[1], fields[2]))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    public:
+
+    // Constructor for an empty roster
+    DeveloperRoster() : count_(0){}
+
+    // Constructor for developers "1" to count with no limits
+    explicit DeveloperRoster(size_t count) : count_(count){}
+
+    // Return the number of developers
+    size_t size() const
+    {
+        return count_;
+    }
+
+    // Return true if there are no developers, otherwise false
+    bool empty() const
+    {
+        return count_ == 0;
+    }
+
+    // Add a developer at the end of a roster loaded from a file or built with add()
+    void add(std::string_view id, unsigned capacity, uint8_t impacts)
+    {
+        if (count_ > idEnds_.size())
+        {
+            throw std::logic_error("DeveloperRoster::add - Roster is numbered");
+        }
+        if (ids_.size() + id.size() > UINT32_MAX)
+        {
+            throw std::length_error("DeveloperRoster::add - Too many developers");
+        }
+
+        ids_.insert(ids_.end(), id.begin(), id.end());
+        idEnds_.push_back(static_cast<uint32_t>(ids_.size()));
+        capacities_.push_back(capacity);
+        impacts_.push_back(impacts);
+        ++count_;
+    }
+
+    // Return the id of a developer, numbered from 0
+    std::string id(size_t developer) const
+    {
+        if (idEnds_.empty())
+        {
+            return std::to_string(developer + 1);
+        }
+
+        uint32_t begin = developer == 0 ? 0 : idEnds_[developer - 1];
+        return std::string(ids_.data() + begin, idEnds_[developer] - begin);
+    }
+
+    // Return the most bugs a developer takes
+    unsigned capacity(size_t developer) const
+    {
+        return capacities_.empty() ? UINT_MAX : capacities_[developer];
+    }
+
+    // Return the mask of impact levels a developer takes
+    uint8_t impacts(size_t developer) const
+    {
+        return impacts_.empty() ? ALL_IMPACTS : impacts_[developer];
+    }
+
+    // Replace the roster with the one in an xml file, or a csv file if path ends in ".csv".
+    // Return false (after printing why) if the file can't be loaded.
+    bool load(std::string const &path)
+    {
+        *this = DeveloperRoster();
+
+        bool csv = path.size() >= 4 && path.compare(path.size() - 4, 4, ".csv") == 0;
+        return csv ? loadCsv(path) : loadXml(path);
+    }
+};
+
+#endif
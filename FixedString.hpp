@@ -0,0 +1,112 @@
+#ifndef FIXED_STRING_HPP
+#define FIXED_STRING_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include "StringPool.hpp"
+
+
+// Text of at most CAPACITY characters stored inline, for Bug fields with a
+// known maximum length. Copying one is a plain memory copy.
+//
+// Longer text, which only malformed exports contain, is interned in a
+// process-wide pool for the capacity and the array holds its handle instead,
+// so every value still round-trips exactly. The pool is never freed, so
+// long-running code must validate text before storing it here, as the
+// server does, and reading a pooled value takes the pool's mutex on every
+// view() or comparison. Inline values never touch the pool or the lock.
+template <size_t CAPACITY>
+class FixedString
+{
+    private:
+
+    static_assert(CAPACITY >= sizeof(uint32_t) && CAPACITY < 255, "FixedString capacity must be 4 to 254");
+
+    static uint8_t const POOLED = 255;
+
+    char text_[CAPACITY];
+    uint8_t length_;    // POOLED if text_ holds a handle into the overflow pool
+
+    struct Overflow
+    {
+        std::mutex mutex;
+        StringPool pool;
+
+        Overflow() : pool(true){}
+    };
+
+    static Overflow &overflow()
+    {
+        static Overflow table;
+        return table;
+    }
+
+    public:
+
+    // Constructor for an empty string
+    FixedString() : length_(0){}
+
+    // Constructor from text of any length
+    explicit FixedString(std::string_view text)
+    {
+        if (text.size() <= CAPACITY)
+        {
+            std::memcpy(text_, text.data(), text.size());
+            length_ = static_cast<uint8_t>(text.size());
+            return;
+        }
+
+        Overflow &table = overflow();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        uint32_t handle = table.pool.add(text);
+        std::memcpy(text_, &handle, sizeof(handle));
+        length_ = POOLED;
+    }
+
+    // Return true if the text is stored inline, otherwise false
+    bool inlined() const
+    {
+        return length_ != POOLED;
+    }
+
+    // Return the text. Pooled text stays valid for the life of the program.
+    std::string_view view() const
+    {
+        if (length_ != POOLED)
+        {
+            return std::string_view(text_, length_);
+        }
+
+        uint32_t handle;
+        std::memcpy(&handle, text_, sizeof(handle));
+        Overflow &table = overflow();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        return table.pool.get(handle);
+    }
+
+    // Return the text as a string
+    std::string str() const
+    {
+        return std::string(view());
+    }
+
+    bool operator ==(FixedString const &rhs) const
+    {
+        return view() == rhs.view();
+    }
+
+    bool operator <(FixedString const &rhs) const
+    {
+        return view() < rhs.view();
+    }
+
+    bool operator >(FixedString const &rhs) const
+    {
+        return rhs.view() < view();
+    }
+};
+
+#endif
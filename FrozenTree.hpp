@@ -0,0 +1,212 @@
+#ifndef FROZEN_TREE_HPP
+#define FROZEN_TREE_HPP
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "SortKey.hpp"
+
+
+// Read-only ordered index produced by freezing a BinarySearchTree or BTree.
+// Elements sit in one sorted array; their compact keys are laid out again in
+// Eytzinger (breadth-first) order, so a search walks down one implicit tree
+// with no pointers, and the few cache lines it touches next can be prefetched
+// while the current comparison runs.
+template <typename T>
+class FrozenTree
+{
+    private:
+
+    typedef typename SortKey<T>::type Key;
+
+    // Slot k's descendants four levels down start at slot 16k and are
+    // contiguous, so the search prefetches there while comparing at k
+    static size_t const PREFETCH_STRIDE = 16;
+
+    std::vector<T> sorted_;
+    std::vector<Key> keys_;         // 1-based Eytzinger order; keys_[0] is unused
+    std::vector<uint32_t> ranks_;   // position in sorted_ of each keys_ entry
+
+
+    // Recursively copy keys into Eytzinger slot k and its subtree, taking
+    // elements from sorted_ in order starting at index.
+    // Return the index of the next element to place
+    size_t layout(size_t index, size_t k)
+    {
+        if (k < keys_.size())
+        {
+            index = layout(index, 2 * k);
+            keys_[k] = SortKey<T>::get(sorted_[index]);
+            ranks_[k] = static_cast<uint32_t>(index);
+            index = layout(index + 1, 2 * k + 1);
+        }
+
+        return index;
+    }
+
+    // Return the position of the first element whose key isn't below key
+    // (or that compares above it, if STRICT), or size() if there is none
+    template <bool STRICT>
+    size_t search(Key const &key) const
+    {
+        size_t const count = keys_.size();
+        Key const *keys = keys_.data();
+        size_t k = 1;
+
+        while (k < count)
+        {
+#if defined(__GNUC__)
+            __builtin_prefetch(keys + (k * PREFETCH_STRIDE < count ? k * PREFETCH_STRIDE : 0));
+#endif
+            // Go right past keys below key (or equal to it, if STRICT), without branching
+            bool right = STRICT ? !(key < keys[k]) : keys[k] < key;
+            k = 2 * k + right;
+        }
+
+        // Undo the right turns taken after the last left turn; that node is the answer
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+        return k == 0 ? sorted_.size() : ranks_[k];
+    }
+
+
+    public:
+
+    // Constructor for an empty index
+    FrozenTree() : keys_(1), ranks_(1){}
+
+    // Constructor from elements already in ascending order with distinct keys
+    explicit FrozenTree(std::vector<T> sorted) : sorted_(std::move(sorted)), keys_(sorted_.size() + 1),
+        ranks_(sorted_.size() + 1)
+    {
+        layout(0, 1);
+    }
+
+    // Return true if the index is empty, otherwise false
+    bool empty() const
+    {
+        return sorted_.empty();
+    }
+
+    // Return the number of elements in the index
+    size_t size() const
+    {
+        return sorted_.size();
+    }
+
+    // Return the element at a position in ascending order
+    T const &at(size_t index) const
+    {
+        return sorted_.at(index);
+    }
+
+    // Return pointer to minimum data in index, or null if empty
+    T const * findMinimum() const
+    {
+        return sorted_.empty() ? nullptr : &sorted_.front();
+    }
+
+    // Return pointer to maximum data in index, or null if empty
+    T const * findMaximum() const
+    {
+        return sorted_.empty() ? nullptr : &sorted_.back();
+    }
+
+    // Return the position of the first element not below probe, or size() if none
+    size_t lowerBound(T const &probe) const
+    {
+        return search<false>(SortKey<T>::get(probe));
+    }
+
+    // Return the position of the first element above probe, or size() if none
+    size_t upperBound(T const &probe) const
+    {
+        return search<true>(SortKey<T>::get(probe));
+    }
+
+    // Return pointer to the element with the same key as probe, or null if none
+    T const * find(T const &probe) const
+    {
+        Key key = SortKey<T>::get(probe);
+        size_t index = search<false>(key);
+        if (index < sorted_.size() && !(key < SortKey<T>::get(sorted_[index])))
+        {
+            return &sorted_[index];
+        }
+
+        return nullptr;
+    }
+
+
+
+    // Frozen tree iterator over a run of positions in ascending order
+    class Iterator
+    {
+        private:
+        T const *current_;
+        T const *end_;
+
+        public:
+
+        // Constructor
+        Iterator(T const *begin, T const *end) : current_(begin), end_(end){}
+
+        // Get immutable pointer to current element
+        T const * current()
+        {
+            return current_ != end_ ? current_ : nullptr;
+        }
+
+        // Move to the next element
+        void next()
+        {
+            if (current_ != end_)
+            {
+                ++current_;
+            }
+        }
+
+        // Return true if there is a next element, otherwise false
+        bool hasNext()
+        {
+            return current_ != end_;
+        }
+
+    };
+
+
+    // STL iterators are plain pointers into the sorted array
+    typedef T const* iterator;
+    typedef T const* const_iterator;
+
+    const_iterator begin() const
+    {
+        return sorted_.data();
+    }
+
+    const_iterator end() const
+    {
+        return sorted_.data() + sorted_.size();
+    }
+
+    // Return a new in-order iterator object
+    Iterator generateIterator() const
+    {
+        return Iterator(sorted_.data(), sorted_.data() + sorted_.size());
+    }
+
+    // Return an iterator over every element from low up to and including high
+    Iterator generateRange(T const &low, T const &high) const
+    {
+        size_t begin = lowerBound(low);
+        size_t end = upperBound(high);
+        if (end < begin)
+        {
+            end = begin;
+        }
+
+        return Iterator(sorted_.data() + begin, sorted_.data() + end);
+    }
+
+};
+
+#endif
@@ -2,45 +2,115 @@
 #define _HASHTABLE_HPP_
 
 #include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
 #include "LinkedList.hpp"
 using std::string;
 using std::pair;
 
 
+// Hashing for each HashTable key type. lookup_type is what add/get/remove
+// accept; the string keys take a string_view so lookups don't need a string.
+template <typename K> struct HashKey;
+
+template <>
+struct HashKey<string>
+{
+    typedef std::string_view lookup_type;
+
+    // Sum of the characters
+    static size_t hash(std::string_view key)
+    {
+        size_t sum(0);
+        for (char c : key)
+        {
+            sum += c;
+        }
+        return sum;
+    }
+};
+
+
 // Templated hash table data type definition
 // Uses separate chaining for collision resolution
-template <typename T, size_t TABLE_SIZE=11>
+template <typename T, size_t TABLE_SIZE=11, typename K = string>
 class HashTable
 {
     private:
 
+    typedef typename HashKey<K>::lookup_type Lookup;
+
+    static size_t const WORD_BITS = 64;
+    static size_t const WORD_COUNT = (TABLE_SIZE + WORD_BITS - 1) / WORD_BITS;
+
     // Array of linked lists to hold all data
-    std::array<LinkedList<pair<string, T>>, TABLE_SIZE> table_;
+    std::array<LinkedList<pair<K, T>>, TABLE_SIZE> table_;
 
-    // Hashing function
-    size_t hash(string const &key) const
+    // One bit per bucket, set while the bucket holds entries, so iteration
+    // can skip a whole word of empty buckets at a time
+    std::array<uint64_t, WORD_COUNT> occupied_;
+
+    // Number of entries in the table
+    size_t count_;
+
+    // Create alias for linked list iterator to make life easier ;)
+    using listIter = typename LinkedList<pair<K, T>>::Iterator;
+
+    // Return the first occupied bucket at or after index, or TABLE_SIZE if none
+    static size_t nextOccupied(uint64_t const *occupied, size_t index)
     {
-        size_t sum(0);
-        for (char c : key)
+        if (index >= TABLE_SIZE)
         {
-            sum += c;
+            return TABLE_SIZE;
         }
-        return sum % TABLE_SIZE;
-    }
 
-    // Create alias for linked list iterator to make life easier ;)
-    using listIter = typename LinkedList<pair<string, T>>::Iterator;
+        size_t word = index / WORD_BITS;
+        uint64_t bits = occupied[word] & (~uint64_t(0) << (index % WORD_BITS));
+        while (bits == 0)
+        {
+            if (++word == WORD_COUNT)
+            {
+                return TABLE_SIZE;
+            }
+            bits = occupied[word];
+        }
+
+        return word * WORD_BITS + __builtin_ctzll(bits);
+    }
 
     public:
 
+    // Constructor
+    HashTable() : occupied_(), count_(0){}
+
+    // Hashing function. String keys can be given as a string, string_view
+    // or const char*. Callers using the same key more than once can compute
+    // this once and pass it to the overloads taking a hash.
+    static size_t hash(Lookup key)
+    {
+        return HashKey<K>::hash(key);
+    }
+
     // Add new key/value entry in hash table.
     // Will return true if successfully added, will return
     // false if key value already exists.
-    bool add(string const &key, T const &value)
+    bool add(Lookup key, T const &value)
+    {
+        return add(key, value, hash(key));
+    }
+
+    // Same as add(key, value), with keyHash = hash(key) already computed
+    bool add(Lookup key, T const &value, size_t keyHash)
     {
-        if (get(key) == nullptr)
+        if (get(key, keyHash) == nullptr)
         {
-            table_.at(hash(key)).pushFront(pair<string, T>(key, value));
+            size_t index = keyHash % TABLE_SIZE;
+            table_.at(index).pushFront(pair<K, T>(K(key), value));
+            occupied_[index / WORD_BITS] |= uint64_t(1) << (index % WORD_BITS);
+            ++count_;
             return true;
         }
 
@@ -49,11 +119,18 @@ class HashTable
 
     // Remove entry with matching key from hash table.
     // Do nothing if no entry has matching key.
-    void remove(string const &key)
+    void remove(Lookup key)
+    {
+        remove(key, hash(key));
+    }
+
+    // Same as remove(key), with keyHash = hash(key) already computed
+    void remove(Lookup key, size_t keyHash)
     {
         // Make sure to make a reference or you will be
         // removing item from copy
-        LinkedList<pair<string, T>> &vals = table_.at(hash(key));
+        size_t index = keyHash % TABLE_SIZE;
+        LinkedList<pair<K, T>> &vals = table_.at(index);
 
         size_t counter(0);
         for (listIter iter = vals.generateIterator(); iter.hasNext(); iter.next())
@@ -61,6 +138,11 @@ class HashTable
             if (iter.current()->first == key)
             {
                 vals.removeAt(counter);
+                --count_;
+                if (vals.empty())
+                {
+                    occupied_[index / WORD_BITS] &= ~(uint64_t(1) << (index % WORD_BITS));
+                }
                 break;
             }
 
@@ -70,11 +152,17 @@ class HashTable
 
     // Retrieve pointer to value associated with key.
     // Will return null pointer if no matching key is found.  
-    T* get(string const &key)
+    T* get(Lookup key)
     {
-        LinkedList<pair<string, T>> &vals = table_.at(hash(key));
+        return get(key, hash(key));
+    }
 
-        if (vals.size() > 0)
+    // Same as get(key), with keyHash = hash(key) already computed
+    T* get(Lookup key, size_t keyHash)
+    {
+        LinkedList<pair<K, T>> &vals = table_.at(keyHash % TABLE_SIZE);
+
+        if (!vals.empty())
         {
             for (listIter iter = vals.generateIterator(); iter.hasNext(); iter.next())
             {
@@ -91,57 +179,46 @@ class HashTable
     // Return the number of entries in hash table
     size_t size()
     {
-        size_t size(0);
-
-        for (LinkedList<pair<string, T>> &list : table_)
-        {
-            for (listIter iter = list.generateIterator(); iter.hasNext(); iter.next())
-            {
-                ++size;
-            }
-        }
-
-        return size;
+        return count_;
     }
 
     // Remove all entries from the hash table
     void clear()
     {
-        for (LinkedList<pair<string, T>> &list : table_)
+        for (LinkedList<pair<K, T>> &list : table_)
         {
             list.clear();
         }
+        occupied_.fill(0);
+        count_ = 0;
     }
 
 
 
-    // HashTable iterator
+    // HashTable iterator. It always rests on an entry or past the end, and
+    // finds the next occupied bucket from the bitmap, so a full iteration is
+    // linear in the number of entries.
     class Iterator
     {
         private:
-        std::array<LinkedList<pair<string, T>>, TABLE_SIZE>* tablePtr_;
+        HashTable* table_;
         listIter tableIndexIter_;
         size_t index_;
 
         public:
         
         // Constructor
-        Iterator(std::array<LinkedList<pair<string, T>>, TABLE_SIZE>* tablePtr) 
-            : tablePtr_(tablePtr), tableIndexIter_(tablePtr_->at(0).generateIterator()), index_(0)
+        Iterator(HashTable* table)
+            : table_(table), tableIndexIter_(nullptr), index_(nextOccupied(table->occupied_.data(), 0))
         {
-            while (!tableIndexIter_.hasNext())
+            if (index_ < TABLE_SIZE)
             {
-                if (++index_ >= TABLE_SIZE)
-                {
-                    break;
-                }
-
-                tableIndexIter_ = tablePtr_->at(index_).generateIterator();
+                tableIndexIter_ = table_->table_.at(index_).generateIterator();
             }
         }
 
         // Get current value
-        pair<string, T>* current()
+        pair<K, T>* current()
         {
             return tableIndexIter_.current();
         }
@@ -155,41 +232,140 @@ class HashTable
                 return;
             }
 
-            while (++index_ < TABLE_SIZE)
+            index_ = nextOccupied(table_->occupied_.data(), index_ + 1);
+            if (index_ < TABLE_SIZE)
             {
-                if (!tablePtr_->at(index_).empty())
-                {
-                    tableIndexIter_ = tablePtr_->at(index_).generateIterator();
-                    break;
-                }
+                tableIndexIter_ = table_->table_.at(index_).generateIterator();
             }
         }
 
         // Check if iterator has reached end of hash table
         bool hasNext()
         {
-            size_t tempIndex = index_;
-            if (tableIndexIter_.hasNext())
-            {
-                return true;
-            }
+            return tableIndexIter_.hasNext();
+        }
+    };
+
+    // Generate iterator for hash table
+    Iterator generateIterator()
+    {
+        return Iterator(this);
+    }
 
-            while (++tempIndex < TABLE_SIZE)
+
+
+    // STL forward iterator over every entry, bucket by bucket.
+    // Value is pair<K, T> for iterator and pair<K, T> const for const_iterator.
+    template <typename Value, typename Bucket, typename EntryIterator>
+    class StlIterator
+    {
+        private:
+        Bucket* buckets_;
+        uint64_t const *occupied_;
+        size_t index_;
+        EntryIterator entry_;
+
+        // Move from the end of a bucket to the next occupied one, or to end()
+        void skipEmpty()
+        {
+            if (index_ < TABLE_SIZE && entry_ == EntryIterator())
             {
-                if (!tablePtr_->at(tempIndex).empty())
+                index_ = nextOccupied(occupied_, index_ + 1);
+                if (index_ < TABLE_SIZE)
                 {
-                    return true;
+                    entry_ = buckets_[index_].begin();
                 }
             }
+        }
+
+        public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef pair<K, T> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        StlIterator() : buckets_(nullptr), occupied_(nullptr), index_(TABLE_SIZE){}
+
+        // Start at the first occupied bucket
+        StlIterator(Bucket* buckets, uint64_t const *occupied)
+            : buckets_(buckets), occupied_(occupied), index_(nextOccupied(occupied, 0))
+        {
+            if (index_ < TABLE_SIZE)
+            {
+                entry_ = buckets_[index_].begin();
+            }
+        }
+
+        StlIterator(Bucket* buckets, uint64_t const *occupied, size_t index, EntryIterator entry)
+            : buckets_(buckets), occupied_(occupied), index_(index), entry_(entry){}
 
-            return false;
+        // Allow an iterator wherever a const_iterator is expected
+        operator StlIterator<pair<K, T> const, LinkedList<pair<K, T>> const,
+                             typename LinkedList<pair<K, T>>::const_iterator>() const
+        {
+            return StlIterator<pair<K, T> const, LinkedList<pair<K, T>> const,
+                               typename LinkedList<pair<K, T>>::const_iterator>(buckets_, occupied_, index_, entry_);
+        }
+
+        reference operator *() const
+        {
+            return *entry_;
+        }
+
+        pointer operator ->() const
+        {
+            return &*entry_;
+        }
+
+        StlIterator &operator ++()
+        {
+            ++entry_;
+            skipEmpty();
+            return *this;
+        }
+
+        StlIterator operator ++(int)
+        {
+            StlIterator previous(*this);
+            ++*this;
+            return previous;
+        }
+
+        bool operator ==(StlIterator const &rhs) const
+        {
+            return index_ == rhs.index_ && entry_ == rhs.entry_;
+        }
+
+        bool operator !=(StlIterator const &rhs) const
+        {
+            return !(*this == rhs);
         }
     };
 
-    // Generate iterator for hash table
-    Iterator generateIterator()
+    typedef LinkedList<pair<K, T>> Bucket;
+    typedef StlIterator<pair<K, T>, Bucket, typename Bucket::iterator> iterator;
+    typedef StlIterator<pair<K, T> const, Bucket const, typename Bucket::const_iterator> const_iterator;
+
+    iterator begin()
+    {
+        return iterator(table_.data(), occupied_.data());
+    }
+
+    iterator end()
+    {
+        return iterator();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(table_.data(), occupied_.data());
+    }
+
+    const_iterator end() const
     {
-        return Iterator(&table_);
+        return const_iterator();
     }
 
 };
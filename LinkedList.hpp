@@ -1,6 +1,8 @@
 #ifndef LINKED_LIST_HPP
 #define LINKED_LIST_HPP
 
+#include <cstddef>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
@@ -239,6 +241,91 @@ class LinkedList
         return Iterator(head_);
     }
 
+
+
+    // STL forward iterator, for range-for and <algorithm>.
+    // Value is T for iterator and T const for const_iterator.
+    template <typename Value>
+    class StlIterator
+    {
+        private:
+        Node* node_;
+
+        public:
+
+        typedef std::forward_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef Value* pointer;
+        typedef Value& reference;
+
+        StlIterator() : node_(nullptr){}
+
+        explicit StlIterator(Node* node) : node_(node){}
+
+        // Allow an iterator wherever a const_iterator is expected
+        operator StlIterator<T const>() const
+        {
+            return StlIterator<T const>(node_);
+        }
+
+        reference operator *() const
+        {
+            return node_->data;
+        }
+
+        pointer operator ->() const
+        {
+            return &node_->data;
+        }
+
+        StlIterator &operator ++()
+        {
+            node_ = node_->next;
+            return *this;
+        }
+
+        StlIterator operator ++(int)
+        {
+            StlIterator previous(*this);
+            node_ = node_->next;
+            return previous;
+        }
+
+        bool operator ==(StlIterator const &rhs) const
+        {
+            return node_ == rhs.node_;
+        }
+
+        bool operator !=(StlIterator const &rhs) const
+        {
+            return node_ != rhs.node_;
+        }
+    };
+
+    typedef StlIterator<T> iterator;
+    typedef StlIterator<T const> const_iterator;
+
+    iterator begin()
+    {
+        return iterator(head_);
+    }
+
+    iterator end()
+    {
+        return iterator();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(head_);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator();
+    }
+
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,231 @@
+#ifndef MIN_HEAP_HPP
+#define MIN_HEAP_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include "SortKey.hpp"
+
+
+// Priority queue handing out its minimum first, as an ARITY-ary heap over one
+// contiguous array. The heap itself only moves small entries holding the
+// compact sort key; elements stay put in a separate slot array.
+// Unlike the trees it keeps elements with equal keys, and pops those in the
+// order they were pushed.
+template <typename T, size_t ARITY = 4>
+class MinHeap
+{
+    private:
+
+    static_assert(ARITY >= 2, "MinHeap needs at least two children per entry");
+
+    typedef typename SortKey<T>::type Key;
+
+    struct Entry
+    {
+        Key key;
+        uint32_t sequence;  // push order, to break ties between equal elements
+        uint32_t slot;      // index of the element in items_
+    };
+
+    std::vector<Entry> heap_;
+    std::vector<T> items_;
+    std::vector<uint32_t> freeSlots_;   // items_ slots whose element has been popped
+    uint32_t nextSequence_;
+
+
+    // Store data in a free slot and return its index
+    uint32_t store(T &data)
+    {
+        if (freeSlots_.empty())
+        {
+            items_.push_back(std::move(data));
+            return static_cast<uint32_t>(items_.size() - 1);
+        }
+
+        uint32_t slot = freeSlots_.back();
+        freeSlots_.pop_back();
+        items_[slot] = std::move(data);
+        return slot;
+    }
+
+    // Return true if a's element pops before b's: by key, then by the
+    // elements themselves, so equal keys never stand in for equal elements,
+    // then in push order
+    bool less(Entry const &a, Entry const &b)
+    {
+        if (a.key < b.key)
+        {
+            return true;
+        }
+        if (b.key < a.key)
+        {
+            return false;
+        }
+        if (items_[a.slot] < items_[b.slot])
+        {
+            return true;
+        }
+        if (items_[b.slot] < items_[a.slot])
+        {
+            return false;
+        }
+        return a.sequence < b.sequence;
+    }
+
+    // Move the entry at index up until its parent is smaller
+    void siftUp(size_t index)
+    {
+        Entry entry = heap_[index];
+        while (index > 0)
+        {
+            size_t parent = (index - 1) / ARITY;
+            if (!less(entry, heap_[parent]))
+            {
+                break;
+            }
+            heap_[index] = heap_[parent];
+            index = parent;
+        }
+        heap_[index] = entry;
+    }
+
+    // Move the entry at index down until none of its children is smaller
+    void siftDown(size_t index)
+    {
+        size_t const count = heap_.size();
+        Entry entry = heap_[index];
+
+        while (true)
+        {
+            size_t first = index * ARITY + 1;
+            if (first >= count)
+            {
+                break;
+            }
+
+            size_t last = first + ARITY < count ? first + ARITY : count;
+            size_t smallest = first;
+            for (size_t child = first + 1; child < last; ++child)
+            {
+                if (less(heap_[child], heap_[smallest]))
+                {
+                    smallest = child;
+                }
+            }
+
+            if (!less(heap_[smallest], entry))
+            {
+                break;
+            }
+            heap_[index] = heap_[smallest];
+            index = smallest;
+        }
+        heap_[index] = entry;
+    }
+
+
+    public:
+
+    // Constructor
+    MinHeap() : nextSequence_(0){}
+
+    // Return true if the heap is empty, otherwise false
+    bool empty()
+    {
+        return heap_.empty();
+    }
+
+    // Return the number of elements in the heap
+    size_t size()
+    {
+        return heap_.size();
+    }
+
+    // Add new data to the heap
+    void push(T data)
+    {
+        Entry entry = { SortKey<T>::get(data), nextSequence_++, 0 };
+        entry.slot = store(data);
+        heap_.push_back(entry);
+        siftUp(heap_.size() - 1);
+    }
+
+    // Add every element of items to the heap at once, in O(n) rather than
+    // O(n log n) for pushing them one at a time. Equal keys pop in items order.
+    void heapify(std::vector<T> items)
+    {
+        heap_.reserve(heap_.size() + items.size());
+        if (items_.empty())
+        {
+            items_.swap(items);
+            for (size_t i(0); i < items_.size(); ++i)
+            {
+                heap_.push_back(Entry{ SortKey<T>::get(items_[i]), nextSequence_++, static_cast<uint32_t>(i) });
+            }
+        }
+        else
+        {
+            for (T &data : items)
+            {
+                Entry entry = { SortKey<T>::get(data), nextSequence_++, 0 };
+                entry.slot = store(data);
+                heap_.push_back(entry);
+            }
+        }
+
+        // Floyd's construction: sift down every parent, deepest first
+        if (heap_.size() > 1)
+        {
+            for (size_t i = (heap_.size() - 2) / ARITY + 1; i > 0; --i)
+            {
+                siftDown(i - 1);
+            }
+        }
+    }
+
+    // Return pointer to minimum data in heap, or null if empty heap
+    T const * findMinimum()
+    {
+        return heap_.empty() ? nullptr : &items_[heap_[0].slot];
+    }
+
+    // Remove the minimum element from the heap and return it
+    T popMinimum()
+    {
+        if (heap_.empty())
+        {
+            throw std::logic_error("MinHeap::popMinimum - Heap is empty");
+        }
+
+        uint32_t slot = heap_[0].slot;
+        T returnData(std::move(items_[slot]));
+
+        heap_[0] = heap_.back();
+        heap_.pop_back();
+        if (heap_.empty())
+        {
+            clear();
+        }
+        else
+        {
+            freeSlots_.push_back(slot);
+            siftDown(0);
+        }
+
+        return returnData;
+    }
+
+    // Remove all elements in the heap
+    void clear()
+    {
+        heap_.clear();
+        items_.clear();
+        freeSlots_.clear();
+        nextSequence_ = 0;
+    }
+
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+
+// Call work(index, worker) for every index below count, spreading the
+// indices over up to the given number of threads. worker identifies the
+// calling thread (0 to threads-1) so per-thread state can be reused.
+template <typename Work>
+void forEachOnThreads(size_t count, unsigned threads, Work work)
+{
+    std::atomic<size_t> nextIndex(0);
+
+    auto worker = [&](unsigned workerIndex)
+    {
+        for (size_t i = nextIndex++; i < count; i = nextIndex++)
+        {
+            work(i, workerIndex);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads && t < count; t++)
+    {
+        workers.push_back(std::thread(worker, t));
+    }
+    worker(0);
+    for (std::thread &t : workers)
+    {
+        t.join();
+    }
+}
+
+#endif
@@ -5,75 +5,47 @@ Date Completed: 5/20/24
 Description: Program that helps team leads assign
 bugs to teamleads in xml format. Will be converted
 from xml to html by front-end team.
+Build: g++ -std=c++17 -O2 -pthread Pest-Control.cpp -o Pest-Control
+       (add -DPEST_CONTROL_STATS to print stage timings and counters on stderr,
+       -DPEST_CONTROL_TRACK_ALLOCS to print allocations per label on stderr, where
+       every container built under the same label shares one account)
+Usage: run with --help for the command line options.
+Check: regression/run.sh runs the regression inputs through every container.
 ***************************************/
 
 
 #include <iostream>
 #include <fstream>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
 #include "pugixml.hpp"
 #include "HashTable.hpp"
 #include "BinarySearchTree.hpp"
+#include "BTree.hpp"
+#include "MinHeap.hpp"
+#include "Bug.hpp"
+#include "BugColumns.hpp"
+#include "BugStore.hpp"
+#include "Report.hpp"
+#include "BugServer.hpp"
+#include "BugParser.hpp"
+#include "DeveloperRoster.hpp"
+#include "Parallel.hpp"
+#include "ReportFile.hpp"
+#include "Stats.hpp"
+#include "AllocTracker.hpp"
+#include "AssignmentPolicy.hpp"
 using namespace std;
 
-class Bug {
-
-    private:
-    string m_id;
-    string m_description;
-    string m_impact;
-    string m_date;
-    bool m_assigned;
-
-    public:
-
-    //parameterized constructor
-    Bug(string id, string description, string impact, string date)
-     : m_id(id), m_description(description), m_impact(impact), m_date(date) {};
-
-    // // Setter  **don't need setters
-    // void setid(string s) {
-    //   m_id = s;
-    // }
-
-    string getid()
-    {
-        return m_id;
-    }
-
-    string getdescription() {
-        return m_description;
-    }
-
-    string getimpact()
-    {
-        return m_impact;
-    }
-
-    string getdate()
-    {
-        return m_date;
-    }
-
-
-    bool operator < (Bug const &rhs) {
-        if (m_date < rhs.m_date) {
-            return true;
-        }
-        
-        return false;
-    }
-
-    bool operator > (Bug const &rhs) {
-        if (m_date > rhs.m_date) {
-            return true;
-        }
-        
-        return false;
-    }
-
-
-};
-
 // class Developer {  **developer custom data type not needed
 
 //     private:
@@ -108,177 +80,710 @@ class Bug {
     
 // };
 
-int main () {
-    
+// Command line settings
+struct Options {
+    vector<string> inputs;      // xml bug exports, merged in the order given
+    string output;              // report path, "-" for stdout
+    int devCount;               // -1 asks on cin
+    string rosterPath;          // developers.xml or .csv to assign to instead of devCount numbered developers
+    unsigned threads;           // threads used to parse inputs or run batch files
+    string storePath;           // run from a binary bug store instead of xml
+    string socketPath;          // serve requests on this socket instead of writing a report
+    string importStore;         // convert the inputs into this bug store and exit
+    string batchPath;           // directory or list file of inputs that each get their own report
+    string outputDir;           // where batch reports are written
+    string container;           // container used to order bugs: "bst", "btree", "heap" or "columns"
+    bool internDescriptions;    // store each distinct description once (columns only)
+    DeveloperQuota quota;       // bugs each developer takes
+    bool quotaGiven;            // --quota was given; a roster otherwise fills each capacity
+    int seniorCount;            // the first seniorCount developers take seniorQuota instead
+    DeveloperQuota seniorQuota;
+    bool balance;               // give each bug to the least loaded developer (columns only)
+    unsigned loadWeights[IMPACT_COUNT]; // load a bug of each impact level adds when balancing
+
+    Options() : output("report.xml"), devCount(-1), threads(1), outputDir("."), container("bst"),
+        internDescriptions(false), quota{ { 1, 1, 1 }, UINT_MAX }, quotaGiven(false), seniorCount(0), seniorQuota{ { 2, 1, 1 }, UINT_MAX },
+        balance(false), loadWeights{ 3, 2, 1 } {};
+};
+
+void printUsage(ostream &out, char const *program) {
+    out<<"Usage: "<<program<<" [options]\n"
+       <<"  -i, --input <bugs.xml>        bug export to read, may be repeated (default bugs.xml)\n"
+       <<"  -o, --output <report.xml>     report to write, \"-\" for stdout (default report.xml)\n"
+       <<"  -d, --developers <n>          number of developers (asked on stdin if omitted)\n"
+       <<"      --roster <developers.xml|csv>\n"
+       <<"                                developers to assign to, each with an optional capacity and\n"
+       <<"                                impact levels; without --quota they fill their capacity\n"
+       <<"  -j, --threads <n>             threads for parsing inputs, batch files and writing a\n"
+       <<"                                --container columns report (default 1)\n"
+       <<"  -b, --batch <dir|list>        give every *.xml in dir, or every path listed in the file,\n"
+       <<"                                its own <name>-report.xml, using -j threads\n"
+       <<"      --output-dir <dir>        where batch reports are written (default .)\n"
+       <<"      --container <bst|btree|heap|columns>\n"
+       <<"                                container used to order the bugs (default bst)\n"
+       <<"      --intern-descriptions     with --container columns, store repeated descriptions once\n"
+       <<"      --quota <h,m,l>           high, medium and low bugs per developer (default 1,1,1)\n"
+       <<"      --capacity <n>            most bugs any developer takes (default no limit)\n"
+       <<"      --seniors <n>             the first n developers take --senior-quota instead\n"
+       <<"      --senior-quota <h,m,l>    bugs per senior developer (default 2,1,1)\n"
+       <<"      --balance                 with --container columns, give each bug, oldest first, to the\n"
+       <<"                                least loaded developer; without --quota only capacities limit\n"
+       <<"      --weights <h,m,l>         load a high, medium and low bug adds when balancing (default 3,2,1)\n"
+       <<"      --store <bugs.store>      read bugs from a binary store instead of xml\n"
+       <<"      --import-xml <bugs.xml> <bugs.store>\n"
+       <<"                                convert an export to a binary store and exit\n"
+       <<"      --serve <socket>          keep the bugs loaded and answer requests on a Unix socket\n"
+       <<"  -h, --help                    show this message\n";
+}
+
+// Parse a non-negative count argument.
+// Return false if text isn't plain digits or is out of range.
+bool parseCount(char const *text, long maximum, long &value) {
+    char *end = nullptr;
+    errno = 0;
+    value = strtol(text, &end, 10);
+    return errno == 0 && text[0] >= '0' && text[0] <= '9' && *end == '\0' && value <= maximum;
+}
+
+// Fill options from the command line.
+// Return false (after printing why) if the arguments are invalid.
+bool parseOptions(int argc, char *argv[], Options &options) {
+
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        long value = 0;
+
+        if ((arg == "-i" || arg == "--input") && hasValue) {
+            options.inputs.push_back(argv[++i]);
+        } else if ((arg == "-o" || arg == "--output") && hasValue) {
+            options.output = argv[++i];
+        } else if ((arg == "-d" || arg == "--developers") && hasValue) {
+            if (!parseCount(argv[++i], 1000000000, value)) {
+                cerr<<"Invalid developer count \""<<argv[i]<<"\"\n";
+                return false;
+            }
+            options.devCount = static_cast<int>(value);
+        } else if (arg == "--roster" && hasValue) {
+            options.rosterPath = argv[++i];
+        } else if ((arg == "-j" || arg == "--threads") && hasValue) {
+            if (!parseCount(argv[++i], 1024, value) || value == 0) {
+                cerr<<"Invalid thread count \""<<argv[i]<<"\"\n";
+                return false;
+            }
+            options.threads = static_cast<unsigned>(value);
+        } else if ((arg == "-b" || arg == "--batch") && hasValue) {
+            options.batchPath = argv[++i];
+        } else if (arg == "--output-dir" && hasValue) {
+            options.outputDir = argv[++i];
+        } else if (arg == "--container" && hasValue) {
+            options.container = argv[++i];
+            if (options.container != "bst" && options.container != "btree" && options.container != "heap"
+                && options.container != "columns") {
+                cerr<<"Unknown container \""<<options.container<<"\"\n";
+                return false;
+            }
+        } else if (arg == "--intern-descriptions") {
+            options.internDescriptions = true;
+        } else if ((arg == "--quota" || arg == "--senior-quota") && hasValue) {
+            if (!parseQuota(argv[++i], arg == "--quota" ? options.quota : options.seniorQuota)) {
+                cerr<<"Invalid quota \""<<argv[i]<<"\", expected <high>,<medium>,<low>\n";
+                return false;
+            }
+            options.quotaGiven = options.quotaGiven || arg == "--quota";
+        } else if (arg == "--capacity" && hasValue) {
+            if (!parseCount(argv[++i], UINT_MAX, value)) {
+                cerr<<"Invalid capacity \""<<argv[i]<<"\"\n";
+                return false;
+            }
+            options.quota.capacity = static_cast<unsigned>(value);
+            options.seniorQuota.capacity = static_cast<unsigned>(value);
+        } else if (arg == "--seniors" && hasValue) {
+            if (!parseCount(argv[++i], 1000000000, value)) {
+                cerr<<"Invalid senior developer count \""<<argv[i]<<"\"\n";
+                return false;
+            }
+            options.seniorCount = static_cast<int>(value);
+        } else if (arg == "--balance") {
+            options.balance = true;
+        } else if (arg == "--weights" && hasValue) {
+            if (!parseImpactCounts(argv[++i], options.loadWeights)) {
+                cerr<<"Invalid weights \""<<argv[i]<<"\", expected <high>,<medium>,<low>\n";
+                return false;
+            }
+        } else if (arg == "--store" && hasValue) {
+            options.storePath = argv[++i];
+        } else if (arg == "--serve" && hasValue) {
+            options.socketPath = argv[++i];
+        } else if (arg == "--import-xml" && i + 2 < argc) {
+            options.inputs.push_back(argv[++i]);
+            options.importStore = argv[++i];
+        } else {
+            cerr<<"Unknown or incomplete option \""<<arg<<"\"\n";
+            return false;
+        };
+    };
+
+    int modes = !options.storePath.empty() + !options.socketPath.empty() + !options.importStore.empty()
+              + !options.batchPath.empty();
+    if (modes > 1) {
+        cerr<<"--store, --serve, --import-xml and --batch can't be combined\n";
+        return false;
+    };
+    if (options.internDescriptions && options.container != "columns") {
+        cerr<<"--intern-descriptions needs --container columns\n";
+        return false;
+    };
+    if (!options.rosterPath.empty() && options.devCount >= 0) {
+        cerr<<"--roster can't be combined with --developers\n";
+        return false;
+    };
+    if (options.balance && (options.container != "columns" || modes > 0)) {
+        cerr<<"--balance needs --container columns and a single report\n";
+        return false;
+    };
+    if ((!options.rosterPath.empty() || options.balance) && !options.quotaGiven) {
+        options.quota.perImpact[IMPACT_HIGH] = UINT_MAX;
+        options.quota.perImpact[IMPACT_MEDIUM] = UINT_MAX;
+        options.quota.perImpact[IMPACT_LOW] = UINT_MAX;
+    };
+    if (!options.storePath.empty() && !options.inputs.empty()) {
+        cerr<<"--store can't be combined with --input\n";
+        return false;
+    };
 
-    //get number of developers from cin
-    cout << "Enter the number of developers you wish to assign bugs: ";
-    int devCount = 0;
-    cin >> devCount;
+    if (options.inputs.empty() && options.batchPath.empty()) {
+        options.inputs.push_back("bugs.xml");
+    };
 
+    return true;
+}
+
+// Append the bugs parsed from one file
+void appendBugs(vector<Bug> &bugs, vector<Bug> const &fileBugs) {
+    bugs.insert(bugs.end(), fileBugs.begin(), fileBugs.end());
+}
+
+void appendBugs(BugColumns &bugs, BugColumns const &fileBugs) {
+    bugs.append(fileBugs);
+}
+
+// Parse every input into a vector<Bug> or BugColumns, spreading the files over
+// the given number of threads. Bugs are appended file by file in the order the
+// inputs were given, so the result doesn't depend on the thread count.
+// Each file is parsed into a copy of the still empty bugs, so it gets the
+// same settings, such as description interning.
+template <typename Bugs>
+bool loadAllBugs(vector<string> const &inputs, unsigned threads, Bugs &bugs) {
+
+    vector<Bugs> fileBugs(inputs.size(), bugs);
+    vector<char> loaded(inputs.size(), 0);
+    vector<BugParser> parsers(threads);
+
+    forEachOnThreads(inputs.size(), threads, [&](size_t i, unsigned worker) {
+        STATS_TIMER(STAGE_PARSE);
+        ALLOC_SCOPE("bugs");
+        loaded[i] = parsers[worker].load(inputs[i], fileBugs[i]);
+        STATS_ADD(BUGS_PARSED, fileBugs[i].size());
+    });
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (!loaded[i]) {
+            return false;
+        };
+        appendBugs(bugs, fileBugs[i]);
+    };
 
-    // instantiate the XML doc
-    pugi::xml_document doc;
+    return true;
+}
 
-    // Load the "bugs.xml" file into the xml document variable
-    // if a problem occurred while loading, show error and end program
-    if (!doc.load_file("bugs.xml"))
-    {
-        cerr<<"Problem opening xml file \"bugs.xml\"\n";
-        return 1;
-    }
+// Sort the bugs into one ordered Tree (BinarySearchTree or BTree) per impact
+// level and write the report for the developers
+template <typename Tree>
+void assignBugs(vector<Bug> &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy, ostream &out) {
 
     // //create hash table to store luminaries   **hash table not needed
     // HashTable<Bug> BugTable;
 
-    //create  3 BST's: 1 for each impact level
-    BinarySearchTree<Bug> hiBugBST;
-    BinarySearchTree<Bug> midBugBST;
-    BinarySearchTree<Bug> loBugBST;
+    //create  3 trees: 1 for each impact level
+    Tree hiBugBST;
+    Tree midBugBST;
+    Tree loBugBST;
 
-    // Instantiate an xml node object to represent the root element in the xml document. 
-    // The root element in an xml document is the topmost element in the document.
-    // For the "bugs.xml" file, the root element is the <bugs> element.
-    pugi::xml_node root = doc.first_child();
+    {
+        STATS_TIMER(STAGE_BUILD);
+
+        for (Bug &bug : bugs)
+        {
+            //put bug into its correct BST; if no impact is assigned, goes into loBugBST
+            //(insert returns false for a duplicate created date, which is dropped)
+            bool inserted;
+            if (bug.getimpact() == "high") {
+                ALLOC_SCOPE("hiBugBST");
+                inserted = hiBugBST.insert(bug);
+                STATS_ADD(BUGS_HIGH, 1);
+            } else if (bug.getimpact() == "medium") {
+                ALLOC_SCOPE("midBugBST");
+                inserted = midBugBST.insert(bug);
+                STATS_ADD(BUGS_MEDIUM, 1);
+            } else {
+                ALLOC_SCOPE("loBugBST");
+                inserted = loBugBST.insert(bug);
+                STATS_ADD(BUGS_LOW, 1);
+            };
+            STATS_ADD(DUPLICATES_DROPPED, !inserted);
+            (void)inserted;
+        };
+    }
 
-    // Loop over all <bug> element children of the root element
-    for (pugi::xml_node bugnode : root.children("bug"))
-    {   
-        //create bug
-        string id = bugnode.attribute("id").as_string();
-        string description = bugnode.child_value("description");
-        string impact = bugnode.child_value("impact");
-        string date = bugnode.child_value("created");
-        Bug bug(id, description, impact, date);
+    //now output developers and their assigned bugs, and then the unassigned bugs, in order into the output;
+    //each tree is consumed oldest first in place, so there's no sorted copy of the bugs
+    MinimumQueue<Tree> hiBugs(hiBugBST);
+    MinimumQueue<Tree> midBugs(midBugBST);
+    MinimumQueue<Tree> loBugs(loBugBST);
 
+    STATS_TIMER(STAGE_WRITE);
+    ALLOC_SCOPE("report");
+    STATS_COUNTED_STREAM(reportOut, out);
+    writeReport(reportOut, developers, policy, hiBugs, midBugs, loBugs);
+}
 
-        // //add bugs to hashtable    **hashtable not needed
-        // BugTable.add(id, bug);
+// Same as assignBugs, but with one MinHeap per impact level: each heap is
+// built in one O(n) pass and the report pops the oldest bugs off the top
+void assignBugsFromHeaps(vector<Bug> &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy, ostream &out) {
 
+    vector<Bug> impactBugs[IMPACT_COUNT];
+    MinHeap<Bug> bugHeaps[IMPACT_COUNT];
 
-        //put bug into its correct BST; if no impact is assigned, goes into loBugBST
-        if (bug.getimpact() == "high") {
-            hiBugBST.insert(bug);
-        } else if (bug.getimpact() == "medium") {
-            midBugBST.insert(bug);
-        } else {
-            loBugBST.insert(bug);
+    {
+        STATS_TIMER(STAGE_BUILD);
+        ALLOC_SCOPE("bugHeaps");
+
+        for (Bug &bug : bugs)
+        {
+            impactBugs[impactCode(bug.getimpact())].push_back(bug);
         };
+        STATS_ADD(BUGS_HIGH, impactBugs[IMPACT_HIGH].size());
+        STATS_ADD(BUGS_MEDIUM, impactBugs[IMPACT_MEDIUM].size());
+        STATS_ADD(BUGS_LOW, impactBugs[IMPACT_LOW].size());
+
+        for (size_t impact = 0; impact < IMPACT_COUNT; impact++) {
+            bugHeaps[impact].heapify(move(impactBugs[impact]));
+        };
+    }
 
+    //the heaps keep bugs with duplicate created dates, so the queues drop them as the trees would
+    DistinctMinimumQueue<MinHeap<Bug>> hiBugs(bugHeaps[IMPACT_HIGH]);
+    DistinctMinimumQueue<MinHeap<Bug>> midBugs(bugHeaps[IMPACT_MEDIUM]);
+    DistinctMinimumQueue<MinHeap<Bug>> loBugs(bugHeaps[IMPACT_LOW]);
+
+    STATS_TIMER(STAGE_WRITE);
+    ALLOC_SCOPE("report");
+    {
+        STATS_COUNTED_STREAM(reportOut, out);
+        writeReport(reportOut, developers, policy, hiBugs, midBugs, loBugs);
+    }
+    STATS_ADD(DUPLICATES_DROPPED, hiBugs.dropped() + midBugs.dropped() + loBugs.dropped());
+}
+
+// Order a columnar table, sorting only its keys and impacts, and decide
+// the assignment: planned in one sweep over the developers, or with
+// loadWeights each bug going to the least loaded developer
+void layoutColumns(BugColumns &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                   unsigned const (*loadWeights)[IMPACT_COUNT], ReportLayout &layout) {
+
+    STATS_TIMER(STAGE_BUILD);
+    ALLOC_SCOPE("bugRows");
+
+    vector<uint32_t> impactRows[IMPACT_COUNT];
+    size_t dropped = bugs.orderRows(impactRows);
+    STATS_ADD(DUPLICATES_DROPPED, dropped);
+    (void)dropped;
+
+    STATS_ADD(DESCRIPTIONS_STORED, bugs.descriptionPool().size());
+    STATS_ADD(BUGS_HIGH, bugs.count(IMPACT_HIGH));
+    STATS_ADD(BUGS_MEDIUM, bugs.count(IMPACT_MEDIUM));
+    STATS_ADD(BUGS_LOW, bugs.count(IMPACT_LOW));
+
+    if (loadWeights) {
+        layoutBalancedReport(developers, policy, *loadWeights, bugs, impactRows, layout);
+    } else {
+        layoutReport(developers, policy, impactRows, layout);
     };
+}
+
+// Same as assignBugs, but with a columnar table laid out by layoutColumns;
+// the report reads the text from the table's blob
+void assignBugsFromColumns(BugColumns &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                           unsigned const (*loadWeights)[IMPACT_COUNT], ostream &out) {
+
+    ReportLayout layout;
+    layoutColumns(bugs, developers, policy, loadWeights, layout);
+
+    STATS_TIMER(STAGE_WRITE);
+    ALLOC_SCOPE("report");
+    STATS_COUNTED_STREAM(reportOut, out);
+    writeReport(reportOut, developers, bugs, layout);
+}
+
+// Same as above, writing the report file at outputPath with up to threads
+// threads, each formatting and writing its own part of the file.
+// Return false (after printing why) if it can't be written.
+bool assignBugsFromColumns(BugColumns &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                           unsigned const (*loadWeights)[IMPACT_COUNT], string const &outputPath, unsigned threads) {
+
+    ReportLayout layout;
+    layoutColumns(bugs, developers, policy, loadWeights, layout);
+
+    STATS_TIMER(STAGE_WRITE);
+    ALLOC_SCOPE("report");
+    ReportFile report(developers, bugs, layout);
+    bool written = report.write(outputPath, threads);
+    STATS_ADD(BYTES_WRITTEN, report.bytes());
+    return written;
+}
+
+// assignBugsFromColumns for bugs that have already been parsed into Bugs
+template <bool INTERN_DESCRIPTIONS>
+void assignBugsFromColumns(vector<Bug> &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy, ostream &out) {
+
+    BugColumns columns(INTERN_DESCRIPTIONS);
+    {
+        STATS_TIMER(STAGE_BUILD);
+        ALLOC_SCOPE("bugColumns");
 
+        for (Bug &bug : bugs) {
+            columns.add(bug.getbugid(), bug.getdescription(), bug.getimpact(), bug.getdate());
+        };
+    }
 
-    // Instantiate ofstream stream object to interact with output file
-    ofstream outFile;
+    assignBugsFromColumns(columns, developers, policy, nullptr, out);
+}
+
+typedef void (*AssignFunction)(vector<Bug> &bugs, DeveloperRoster const &developers, AssignmentPolicy const &policy, ostream &out);
+
+// Return the assignBugs instance for a --container name
+AssignFunction assignFunction(string const &container, bool internDescriptions) {
+    if (container == "heap") {
+        return assignBugsFromHeaps;
+    };
+    if (container == "columns") {
+        return internDescriptions ? assignBugsFromColumns<true> : assignBugsFromColumns<false>;
+    };
+
+    return container == "btree" ? assignBugs<BTree<Bug>> : assignBugs<BinarySearchTree<Bug>>;
+}
 
-    // Open output file stream in "truncate" mode
-    outFile.open("report.xml", ofstream::trunc);
+// Expand a --batch argument into input files: every *.xml file of a
+// directory in name order, or the paths listed one per line in a file.
+// Return false (after printing why) if it can't be read.
+bool listBatchInputs(string const &batchPath, vector<string> &inputs) {
 
-    // Check to make sure the file was opened successfully
-    if (!outFile.is_open())
+    error_code error;
+    if (filesystem::is_directory(batchPath, error)) {
+        for (filesystem::directory_entry const &entry : filesystem::directory_iterator(batchPath, error)) {
+            if (entry.is_regular_file(error) && entry.path().extension() == ".xml") {
+                inputs.push_back(entry.path().string());
+            };
+        };
+        sort(inputs.begin(), inputs.end());
+    } else {
+        ifstream listFile(batchPath);
+        if (!listFile.is_open()) {
+            cerr<<"Can't open batch list \""<<batchPath<<"\"\n";
+            return false;
+        };
+
+        string line;
+        while (getline(listFile, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            };
+            if (!line.empty()) {
+                inputs.push_back(line);
+            };
+        };
+    };
+
+    if (error) {
+        cerr<<"Can't read batch directory \""<<batchPath<<"\": "<<error.message()<<"\n";
+        return false;
+    };
+
+    return true;
+}
+
+// Process every batch input on its own: each file gets its own trees and its
+// own "<name>-report.xml" in outputDir. Files are spread over the thread pool
+// and each thread reuses its parser and bug buffer between files.
+int runBatch(vector<string> const &inputs, string const &outputDir, DeveloperRoster const &developers, unsigned threads,
+             AssignmentPolicy const &policy, AssignFunction assign) {
+
+    // Work out every report path up front so two inputs can't race for the same file
+    vector<string> outputs;
+    for (string const &input : inputs) {
+        filesystem::path output = filesystem::path(outputDir) / (filesystem::path(input).stem().string() + "-report.xml");
+        outputs.push_back(output.string());
+    };
+
+    vector<string> sortedOutputs(outputs);
+    sort(sortedOutputs.begin(), sortedOutputs.end());
+    if (adjacent_find(sortedOutputs.begin(), sortedOutputs.end()) != sortedOutputs.end()) {
+        cerr<<"Batch inputs must have distinct file names\n";
+        return 1;
+    };
+
+    vector<BugParser> parsers(threads);
+    vector<vector<Bug>> workerBugs(threads);
+    atomic<size_t> failures(0);
+
+    forEachOnThreads(inputs.size(), threads, [&](size_t i, unsigned worker) {
+        vector<Bug> &bugs = workerBugs[worker];
+        bugs.clear();
+
+        STATS_TIMER_START(parseTimer, STAGE_PARSE);
+        ALLOC_SCOPE("bugs");
+        if (!parsers[worker].load(inputs[i], bugs)) {
+            ++failures;
+            return;
+        };
+        STATS_TIMER_STOP(parseTimer);
+        STATS_ADD(BUGS_PARSED, bugs.size());
+
+        ofstream outFile(outputs[i], ofstream::trunc);
+        if (!outFile.is_open()) {
+            cerr<<"Can't open "<<outputs[i]<<"!"<<endl;
+            ++failures;
+            return;
+        };
+
+        assign(bugs, developers, policy, outFile);
+    });
+
+    return failures == 0 ? 0 : 1;
+}
+
+// Save parsed bugs as a binary bug store
+int importXml(vector<Bug> &bugs, string const &storePath) {
+
+    BugStoreWriter writer;
+
+    for (Bug &bug : bugs)
+    {
+        if (!writer.add(bug.getid(), bug.getdescription(), bug.getimpact(), bug.getdate()))
+        {
+            cerr<<"Bug \""<<bug.getid()<<"\" has an id longer than "<<BugStoreFormat::ID_WIDTH
+                <<" characters, an impact other than high, medium or low (\""<<bug.getimpact()
+                <<"\") or a malformed created date \""<<bug.getdate()<<"\"\n";
+            return 1;
+        }
+    };
+
+    if (!writer.save(storePath.c_str()))
     {
-        cerr<<"Can't open report.xml!"<<endl;
+        cerr<<"Can't write bug store \""<<storePath<<"\"!"<<endl;
         return 1;
     }
 
-    // Write data to the file via insertion operator
-    outFile<<"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"<<endl;
+    return 0;
+}
 
-    outFile<<"<report>"<<endl;
+// Keep the bugs loaded and answer assignment requests on a Unix domain socket until shut down
+int serveBugs(vector<Bug> &bugs, string const &socketPath) {
 
-    //now output developers and their assigned bugs, and then the unassigned bugs, in order into the outFile
+    BugServer server;
 
-    //create linked list for each BST
-    LinkedList<Bug> hiBugLinkedList = hiBugBST.getSortedList();
-    LinkedList<Bug> midBugLinkedList = midBugBST.getSortedList();
-    LinkedList<Bug> loBugLinkedList = loBugBST.getSortedList();
+    for (Bug &bug : bugs)
+    {
+        server.add(bug);
+    };
 
+    cout<<"Serving "<<server.count(IMPACT_HIGH)<<" high, "<<server.count(IMPACT_MEDIUM)<<" medium and "
+        <<server.count(IMPACT_LOW)<<" low impact bugs on "<<socketPath<<endl;
 
-     //create developers and assign bugs, then create xml for them
-    for ( int i=1; i<devCount+1; i++ ) {
+    if (!server.serve(socketPath.c_str()))
+    {
+        cerr<<"Can't listen on socket \""<<socketPath<<"\"\n";
+        return 1;
+    }
 
-        string id = to_string(i);
+    return 0;
+}
 
-        outFile<<"<developer id=\"" << id << "\">"<<endl;
+// Build the assignment policy the options ask for
+unique_ptr<AssignmentPolicy> makePolicy(Options const &options) {
+    if (options.seniorCount > 0) {
+        return unique_ptr<AssignmentPolicy>(new SeniorityPolicy(options.seniorCount, options.seniorQuota, options.quota));
+    };
 
-        if (!hiBugLinkedList.empty()) {
-            Bug hiBug = hiBugLinkedList.popFront();
+    return unique_ptr<AssignmentPolicy>(new UniformPolicy(options.quota));
+}
 
-            outFile<<"<bug id=\"" << hiBug.getid() << "\">"<<endl;
-            outFile<<"<description>"<< hiBug.getdescription() <<"</description>"<<endl;
-            outFile<<"<impact>"<< hiBug.getimpact() <<"</impact>"<<endl;
-            outFile<<"<created>"<< hiBug.getdate() <<"</created>"<<endl;
-            outFile<<"</bug>"<<endl;
-        };
+// Fill developers from the --roster file, or number them from 1 to the
+// --developers count, asking for the count on cin (prompting on prompt) if
+// neither was given.
+// Return false (after printing why) if the roster can't be loaded.
+bool loadDevelopers(Options const &options, ostream &prompt, DeveloperRoster &developers) {
+    if (!options.rosterPath.empty()) {
+        return developers.load(options.rosterPath);
+    };
+
+    int devCount = options.devCount;
+    if (devCount < 0) {
+        prompt << "Enter the number of developers you wish to assign bugs: ";
+        devCount = 0;
+        cin >> devCount;
+    };
+
+    developers = DeveloperRoster(devCount > 0 ? devCount : 0);
+    return true;
+}
 
-        if (!midBugLinkedList.empty()) {
-            Bug midBug = midBugLinkedList.popFront();
+int main (int argc, char *argv[]) {
 
-            outFile<<"<bug id=\"" << midBug.getid() << "\">"<<endl;
-            outFile<<"<description>"<< midBug.getdescription() <<"</description>"<<endl;
-            outFile<<"<impact>"<< midBug.getimpact() <<"</impact>"<<endl;
-            outFile<<"<created>"<< midBug.getdate() <<"</created>"<<endl;
-            outFile<<"</bug>"<<endl;
+    Options options;
+
+    for (int i = 1; i < argc; i++) {
+        if (string(argv[i]) == "-h" || string(argv[i]) == "--help") {
+            printUsage(cout, argv[0]);
+            return 0;
         };
+    };
+
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(cerr, argv[0]);
+        return 1;
+    };
+
+    unique_ptr<AssignmentPolicy> policy = makePolicy(options);
 
-        if (!loBugLinkedList.empty()) {
-            Bug loBug = loBugLinkedList.popFront();
+    if (!options.batchPath.empty()) {
 
-            outFile<<"<bug id=\"" << loBug.getid() << "\">"<<endl;
-            outFile<<"<description>"<< loBug.getdescription() <<"</description>"<<endl;
-            outFile<<"<impact>"<< loBug.getimpact() <<"</impact>"<<endl;
-            outFile<<"<created>"<< loBug.getdate() <<"</created>"<<endl;
-            outFile<<"</bug>"<<endl;
+        //batch inputs are the listed files plus any given with --input
+        vector<string> inputs;
+        if (!listBatchInputs(options.batchPath, inputs)) {
+            return 1;
         };
-       
-        // Developer developer(id, hiBug, midBug, loBug);  **developer custom data type not needed
+        inputs.insert(inputs.end(), options.inputs.begin(), options.inputs.end());
+
+        DeveloperRoster developers;
+        if (!loadDevelopers(options, cout, developers)) {
+            return 1;
+        };
+
+        int status = runBatch(inputs, options.outputDir, developers, options.threads, *policy,
+                              assignFunction(options.container, options.internDescriptions));
+        STATS_REPORT(cerr);
+        ALLOC_REPORT(cerr);
+        return status;
+    };
+
+    //a plain report run with --container columns parses straight into the columnar table
+    bool columnar = options.container == "columns" && options.storePath.empty() && options.importStore.empty()
+                 && options.socketPath.empty();
+    vector<Bug> bugs;
+    BugColumns bugColumns(options.internDescriptions);
+
+    if (options.storePath.empty()
+        && !(columnar ? loadAllBugs(options.inputs, options.threads, bugColumns)
+                      : loadAllBugs(options.inputs, options.threads, bugs))) {
+        return 1;
+    };
 
-        outFile<<"</developer>"<<endl;
+    if (!options.importStore.empty()) {
+        return importXml(bugs, options.importStore);
     };
 
-    //create xml for unassigned high impact bugs, medium impact bugs, and low impact bugs
+    if (!options.socketPath.empty()) {
+        return serveBugs(bugs, options.socketPath);
+    };
 
-    outFile<<"<remaining>"<<endl;
 
-    while (!hiBugLinkedList.empty()) {
-        Bug hiBug = hiBugLinkedList.popFront();
+    //the developer count prompt goes to stderr when the report itself is written to stdout
+    bool toStdout = options.output == "-";
+    DeveloperRoster developers;
+    if (!loadDevelopers(options, toStdout ? cerr : cout, developers)) {
+        return 1;
+    };
 
-        outFile<<"<bug id=\"" << hiBug.getid() << "\">"<<endl;
-        outFile<<"<description>"<< hiBug.getdescription() <<"</description>"<<endl;
-        outFile<<"<impact>"<< hiBug.getimpact() <<"</impact>"<<endl;
-        outFile<<"<created>"<< hiBug.getdate() <<"</created>"<<endl;
-        outFile<<"</bug>"<<endl;
 
+    //map the store before the output is opened, so a missing or corrupt store leaves the old report alone;
+    //its rows are already grouped by impact and sorted oldest first
+    BugStore store;
+    if (!options.storePath.empty()) {
+        STATS_TIMER_START(parseTimer, STAGE_PARSE);
+        if (!store.open(options.storePath.c_str()))
+        {
+            cerr<<"Problem opening bug store \""<<options.storePath<<"\"\n";
+            return 1;
+        }
+        STATS_TIMER_STOP(parseTimer);
     };
 
-    while (!midBugLinkedList.empty()) {
-        Bug midBug = midBugLinkedList.popFront();
 
-        outFile<<"<bug id=\"" << midBug.getid() << "\">"<<endl;
-        outFile<<"<description>"<< midBug.getdescription() <<"</description>"<<endl;
-        outFile<<"<impact>"<< midBug.getimpact() <<"</impact>"<<endl;
-        outFile<<"<created>"<< midBug.getdate() <<"</created>"<<endl;
-        outFile<<"</bug>"<<endl;
+    //with several threads a columnar report is written straight into the file in parallel
+    bool parallelWrite = columnar && !toStdout && options.threads > 1;
+
+    // Instantiate ofstream stream object to interact with output file
+    ofstream outFile;
+
+    //every input is loaded by now, so the old report is only truncated once there is a new one to write
+    if (!toStdout && !parallelWrite) {
+        // Open output file stream in "truncate" mode
+        outFile.open(options.output, ofstream::trunc);
 
+        // Check to make sure the file was opened successfully
+        if (!outFile.is_open())
+        {
+            cerr<<"Can't open "<<options.output<<"!"<<endl;
+            return 1;
+        }
     };
 
-    while (!loBugLinkedList.empty()) {
-        Bug loBug = loBugLinkedList.popFront();
+    ostream &out = toStdout ? cout : outFile;
+
+
+    if (!options.storePath.empty()) {
 
-        outFile<<"<bug id=\"" << loBug.getid() << "\">"<<endl;
-        outFile<<"<description>"<< loBug.getdescription() <<"</description>"<<endl;
-        outFile<<"<impact>"<< loBug.getimpact() <<"</impact>"<<endl;
-        outFile<<"<created>"<< loBug.getdate() <<"</created>"<<endl;
-        outFile<<"</bug>"<<endl;
+        STATS_ADD(BUGS_PARSED, store.size());
+        STATS_ADD(BUGS_HIGH, store.impactEnd(IMPACT_HIGH) - store.impactBegin(IMPACT_HIGH));
+        STATS_ADD(BUGS_MEDIUM, store.impactEnd(IMPACT_MEDIUM) - store.impactBegin(IMPACT_MEDIUM));
+        STATS_ADD(BUGS_LOW, store.impactEnd(IMPACT_LOW) - store.impactBegin(IMPACT_LOW));
 
+        BugStore::Cursor hiBugCursor = store.generateCursor(IMPACT_HIGH);
+        BugStore::Cursor midBugCursor = store.generateCursor(IMPACT_MEDIUM);
+        BugStore::Cursor loBugCursor = store.generateCursor(IMPACT_LOW);
+
+        {
+            STATS_TIMER(STAGE_WRITE);
+            ALLOC_SCOPE("report");
+            STATS_COUNTED_STREAM(reportOut, out);
+            writeReport(reportOut, developers, *policy, hiBugCursor, midBugCursor, loBugCursor);
+        }
+
+        STATS_REPORT(cerr);
+        ALLOC_REPORT(cerr);
+        return 0;
     };
 
-    outFile<<"</remaining>"<<endl;
 
-    outFile<<"</report>";
+    unsigned const (*loadWeights)[IMPACT_COUNT] = options.balance ? &options.loadWeights : nullptr;
+    if (parallelWrite) {
+        if (!assignBugsFromColumns(bugColumns, developers, *policy, loadWeights, options.output, options.threads)) {
+            return 1;
+        };
+    } else if (columnar) {
+        assignBugsFromColumns(bugColumns, developers, *policy, loadWeights, out);
+    } else {
+        assignFunction(options.container, options.internDescriptions)(bugs, developers, *policy, out);
+    };
     
     // Make sure to close the file when you are done
-    outFile.close();
+    if (outFile.is_open()) {
+        outFile.close();
+    };
 
+    STATS_REPORT(cerr);
+    ALLOC_REPORT(cerr);
     return 0;
 };
\ No newline at end of file
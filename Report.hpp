@@ -0,0 +1,521 @@
+#ifndef REPORT_HPP
+#define REPORT_HPP
+
+#include <algorithm>
+#include <ostream>
+#include <stdexcept>
+#include <vector>
+#include <string>
+#include "AssignmentPolicy.hpp"
+#include "Bug.hpp"
+#include "BugColumns.hpp"
+#include "BugStore.hpp"
+#include "DeveloperRoster.hpp"
+#include "MinHeap.hpp"
+
+
+// Write a single <bug> element into the report
+inline void writeBug(std::ostream &outFile, Bug &bug)
+{
+    outFile<<"<bug id=\"" << bug.getbugid() << "\">"<<std::endl;
+    outFile<<"<description>"<< bug.getdescription() <<"</description>"<<std::endl;
+    outFile<<"<impact>"<< bug.getimpact() <<"</impact>"<<std::endl;
+    outFile<<"<created>"<< bug.getdate() <<"</created>"<<std::endl;
+    outFile<<"</bug>"<<std::endl;
+}
+
+// Write a single <bug> element into the report from a bug store row
+inline void writeBug(std::ostream &outFile, BugStore::Record const &bug)
+{
+    outFile<<"<bug id=\"" << bug.id << "\">"<<std::endl;
+    outFile<<"<description>"<< bug.description <<"</description>"<<std::endl;
+    outFile<<"<impact>"<< impactName(bug.impact) <<"</impact>"<<std::endl;
+    outFile<<"<created>"<< formatTimestamp(bug.key) <<"</created>"<<std::endl;
+    outFile<<"</bug>"<<std::endl;
+}
+
+// Write a single <bug> element into the report from a bug columns row
+inline void writeBug(std::ostream &outFile, BugColumns::Record const &bug)
+{
+    outFile<<"<bug id=\"" << bug.id << "\">"<<std::endl;
+    outFile<<"<description>"<< bug.description <<"</description>"<<std::endl;
+    outFile<<"<impact>"<< bug.impact <<"</impact>"<<std::endl;
+    outFile<<"<created>"<< bug.date <<"</created>"<<std::endl;
+    outFile<<"</bug>"<<std::endl;
+}
+
+
+// Queue over an ordered tree (BinarySearchTree or BTree) that pops its
+// minimum, so a report can be written straight from the trees without a
+// sorted copy. The tree is empty once every bug has been popped.
+template <typename Tree>
+class MinimumQueue
+{
+    private:
+    Tree &tree_;
+
+    public:
+
+    MinimumQueue(Tree &tree) : tree_(tree){}
+
+    // Return true if the tree has nothing left in it, otherwise false
+    bool empty()
+    {
+        return tree_.empty();
+    }
+
+    // Remove and return the oldest bug left in the tree
+    auto popFront()
+    {
+        return tree_.popMinimum();
+    }
+};
+
+
+// Queue over a MinHeap that hands out bugs the way the trees would: the
+// heap keeps every bug, so of several with the same created date only the
+// first one pushed is returned and the rest are dropped. Duplicates are
+// found by comparing whole bugs, never by their sort keys alone.
+template <typename Heap>
+class DistinctMinimumQueue
+{
+    private:
+    Heap &heap_;
+    size_t dropped_;
+
+    public:
+
+    DistinctMinimumQueue(Heap &heap) : heap_(heap), dropped_(0){}
+
+    // Return true if the heap has nothing left in it, otherwise false
+    bool empty()
+    {
+        return heap_.empty();
+    }
+
+    // Remove and return the oldest bug left in the heap, dropping any others with the same date
+    auto popFront()
+    {
+        auto data = heap_.popMinimum();
+        while (!heap_.empty() && !(data < *heap_.findMinimum()))
+        {
+            heap_.popMinimum();
+            ++dropped_;
+        }
+        return data;
+    }
+
+    // Return the number of bugs dropped as duplicates so far
+    size_t dropped()
+    {
+        return dropped_;
+    }
+};
+
+
+// Each developer of the roster, in order, gets the oldest remaining bugs its
+// quota from the policy allows, high impact first, skipping the impact
+// levels the developer doesn't take and stopping at the developer's capacity.
+// The queues must hand out their bugs oldest first through empty() /
+// popFront(). Every bug and every developer is visited once, so this is
+// O(bugs + developers).
+template <typename Queue>
+void writeDevelopers(std::ostream &outFile, DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                     Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    Queue *queues[IMPACT_COUNT] = { &hiBugs, &midBugs, &loBugs };
+
+    //create developers and assign bugs, then create xml for them
+    for (size_t i=0; i<developers.size(); i++)
+    {
+        outFile<<"<developer id=\"" << developers.id(i) << "\">"<<std::endl;
+
+        //once every queue is empty the remaining developers get nothing
+        if (!hiBugs.empty() || !midBugs.empty() || !loBugs.empty())
+        {
+            DeveloperQuota quota = policy.quota(static_cast<int>(i + 1));
+            unsigned capacity = std::min(quota.capacity, developers.capacity(i));
+            uint8_t impacts = developers.impacts(i);
+            unsigned taken(0);
+            for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+            {
+                if (!(impacts & (1 << impact)))
+                {
+                    continue;
+                }
+
+                Queue &bugs = *queues[impact];
+                for (unsigned n(0); n < quota.perImpact[impact] && taken < capacity && !bugs.empty(); ++n)
+                {
+                    auto bug = bugs.popFront();
+                    writeBug(outFile, bug);
+                    ++taken;
+                }
+            }
+        }
+
+        outFile<<"</developer>"<<std::endl;
+    }
+}
+
+// Same as above for developers 1 to devCount
+template <typename Queue>
+void writeDevelopers(std::ostream &outFile, int devCount, AssignmentPolicy const &policy,
+                     Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    writeDevelopers(outFile, DeveloperRoster(devCount > 0 ? devCount : 0), policy, hiBugs, midBugs, loBugs);
+}
+
+// Same as above with one bug of each impact level per developer
+template <typename Queue>
+void writeDevelopers(std::ostream &outFile, int devCount, Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    writeDevelopers(outFile, devCount, UniformPolicy(), hiBugs, midBugs, loBugs);
+}
+
+// Write every bug still left in the queues under <remaining>:
+// high impact bugs first, then medium, then low
+template <typename Queue>
+void writeRemaining(std::ostream &outFile, Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    outFile<<"<remaining>"<<std::endl;
+
+    while (!hiBugs.empty())
+    {
+        auto hiBug = hiBugs.popFront();
+        writeBug(outFile, hiBug);
+    }
+
+    while (!midBugs.empty())
+    {
+        auto midBug = midBugs.popFront();
+        writeBug(outFile, midBug);
+    }
+
+    while (!loBugs.empty())
+    {
+        auto loBug = loBugs.popFront();
+        writeBug(outFile, loBug);
+    }
+
+    outFile<<"</remaining>"<<std::endl;
+}
+
+// Write the complete report.xml document, assigning bugs to the roster by policy
+template <typename Queue>
+void writeReport(std::ostream &outFile, DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                 Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    outFile<<"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"<<std::endl;
+
+    outFile<<"<report>"<<std::endl;
+
+    writeDevelopers(outFile, developers, policy, hiBugs, midBugs, loBugs);
+
+    writeRemaining(outFile, hiBugs, midBugs, loBugs);
+
+    outFile<<"</report>";
+}
+
+// Same as above for developers 1 to devCount
+template <typename Queue>
+void writeReport(std::ostream &outFile, int devCount, AssignmentPolicy const &policy,
+                 Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    writeReport(outFile, DeveloperRoster(devCount > 0 ? devCount : 0), policy, hiBugs, midBugs, loBugs);
+}
+
+// Write the complete report.xml document with one bug of each impact level per developer
+template <typename Queue>
+void writeReport(std::ostream &outFile, int devCount, Queue &hiBugs, Queue &midBugs, Queue &loBugs)
+{
+    writeReport(outFile, devCount, UniformPolicy(), hiBugs, midBugs, loBugs);
+}
+
+// Split ordered bugs among the roster in one sweep, the same way
+// writeDevelopers does, without touching the bugs: a cursor per impact level
+// moves past the bugs each developer takes, so a developer's bugs of one
+// impact level are the next run of that level. available holds the number of
+// bugs of each level. Returns the cursors after each developer,
+// IMPACT_COUNT per developer, stopping once every level is used up; the
+// developers after that get nothing.
+inline std::vector<size_t> planAssignment(DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                                          size_t const (&available)[IMPACT_COUNT])
+{
+    std::vector<size_t> ends;
+    size_t cursors[IMPACT_COUNT] = {};
+
+    for (size_t i(0); i < developers.size(); ++i)
+    {
+        bool left(false);
+        for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+        {
+            left = left || cursors[impact] < available[impact];
+        }
+        if (!left)
+        {
+            break;
+        }
+
+        DeveloperQuota quota = policy.quota(static_cast<int>(i + 1));
+        unsigned capacity = std::min(quota.capacity, developers.capacity(i));
+        uint8_t impacts = developers.impacts(i);
+        unsigned taken(0);
+        for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+        {
+            if (impacts & (1 << impact))
+            {
+                size_t take = std::min<size_t>(std::min(quota.perImpact[impact], capacity - taken),
+                                               available[impact] - cursors[impact]);
+                cursors[impact] += take;
+                taken += static_cast<unsigned>(take);
+            }
+            ends.push_back(cursors[impact]);
+        }
+    }
+
+    return ends;
+}
+
+// Where the rows of a columnar table go in a report once the assignment is
+// decided: developer i gets assigned[begin(i)] up to assigned[end(i)], and
+// remaining holds the rows nobody took, high impact first, oldest first.
+// Developers past the end of ends get nothing.
+struct ReportLayout
+{
+    std::vector<uint32_t> assigned;
+    std::vector<size_t> ends;
+    std::vector<uint32_t> remaining;
+
+    // Return where a developer's rows start in assigned
+    size_t begin(size_t developer) const
+    {
+        return developer == 0 ? 0 : end(developer - 1);
+    }
+
+    // Return where a developer's rows end in assigned
+    size_t end(size_t developer) const
+    {
+        if (developer < ends.size())
+        {
+            return ends[developer];
+        }
+        return ends.empty() ? 0 : ends.back();
+    }
+};
+
+// Fill layout with the assignment planAssignment makes for rows that
+// orderRows has split by impact level
+inline void layoutReport(DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                         std::vector<uint32_t> const (&rows)[IMPACT_COUNT], ReportLayout &layout)
+{
+    size_t available[IMPACT_COUNT];
+    for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+    {
+        available[impact] = rows[impact].size();
+    }
+
+    std::vector<size_t> ends = planAssignment(developers, policy, available);
+    size_t begin[IMPACT_COUNT] = {};
+
+    layout.assigned.clear();
+    layout.ends.clear();
+    layout.remaining.clear();
+
+    for (size_t i(0); i < ends.size(); i += IMPACT_COUNT)
+    {
+        for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+        {
+            layout.assigned.insert(layout.assigned.end(), rows[impact].begin() + begin[impact],
+                                   rows[impact].begin() + ends[i + impact]);
+            begin[impact] = ends[i + impact];
+        }
+        layout.ends.push_back(layout.assigned.size());
+    }
+
+    for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+    {
+        layout.remaining.insert(layout.remaining.end(), rows[impact].begin() + begin[impact], rows[impact].end());
+    }
+}
+
+// Write the complete report.xml document for a columnar table laid out by
+// layoutReport or layoutBalancedReport
+inline void writeReport(std::ostream &outFile, DeveloperRoster const &developers, BugColumns const &bugs,
+                        ReportLayout const &layout)
+{
+    outFile<<"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"<<std::endl;
+
+    outFile<<"<report>"<<std::endl;
+
+    for (size_t i(0); i < developers.size(); ++i)
+    {
+        outFile<<"<developer id=\"" << developers.id(i) << "\">"<<std::endl;
+
+        for (size_t n(layout.begin(i)); n < layout.end(i); ++n)
+        {
+            writeBug(outFile, bugs.at(layout.assigned[n]));
+        }
+
+        outFile<<"</developer>"<<std::endl;
+    }
+
+    outFile<<"<remaining>"<<std::endl;
+
+    for (uint32_t row : layout.remaining)
+    {
+        writeBug(outFile, bugs.at(row));
+    }
+
+    outFile<<"</remaining>"<<std::endl;
+
+    outFile<<"</report>";
+}
+
+// A developer's place in a load balancing heap: least loaded first, and of
+// equally loaded developers the one listed first. taken is how many bugs the
+// developer had when the entry was pushed, so outdated entries can be told
+// apart from the developer's current one.
+struct DeveloperLoad
+{
+    uint64_t load;
+    uint32_t developer;
+    uint32_t taken;
+
+    bool operator <(DeveloperLoad const &rhs) const
+    {
+        return load < rhs.load || (load == rhs.load && developer < rhs.developer);
+    }
+};
+
+// Give every bug, oldest first across the impact levels (higher impact first
+// between equal dates), to the least loaded developer that can still take
+// it. A bug adds weights[impact] to its developer's load; developers still
+// keep to their roster capacity and impact levels and to the policy's quota.
+//
+// Each impact level keeps a MinHeap of the developers who take it. A
+// developer's entries aren't updated in place: taking a bug pushes a fresh
+// entry to each of its heaps and the old ones are dropped when they surface,
+// so every assignment costs O(log developers).
+//
+// Fills layout with the result.
+inline void layoutBalancedReport(DeveloperRoster const &developers, AssignmentPolicy const &policy,
+                                 unsigned const (&weights)[IMPACT_COUNT], BugColumns const &bugs,
+                                 std::vector<uint32_t> const (&rows)[IMPACT_COUNT], ReportLayout &layout)
+{
+    if (developers.size() >= UINT32_MAX)
+    {
+        throw std::length_error("layoutBalancedReport - Too many developers");
+    }
+
+    size_t const count = developers.size();
+    std::vector<uint64_t> loads(count, 0);
+    std::vector<uint32_t> taken(count, 0);
+    std::vector<unsigned> room(count);                      // bugs each developer can still take
+    std::vector<unsigned> impactRoom(count * IMPACT_COUNT); // and of each impact level
+    MinHeap<DeveloperLoad> heaps[IMPACT_COUNT];
+
+    {
+        std::vector<DeveloperLoad> entries[IMPACT_COUNT];
+        for (size_t i(0); i < count; ++i)
+        {
+            DeveloperQuota quota = policy.quota(static_cast<int>(i + 1));
+            room[i] = std::min(quota.capacity, developers.capacity(i));
+            for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+            {
+                bool takes = developers.impacts(i) & (1 << impact);
+                impactRoom[i * IMPACT_COUNT + impact] = takes ? quota.perImpact[impact] : 0;
+                if (room[i] > 0 && impactRoom[i * IMPACT_COUNT + impact] > 0)
+                {
+                    entries[impact].push_back(DeveloperLoad{ 0, static_cast<uint32_t>(i), 0 });
+                }
+            }
+        }
+        for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+        {
+            heaps[impact].heapify(std::move(entries[impact]));
+        }
+    }
+
+    // owners[n] is the developer of the n-th bug assigned, which is ownedRows[n]
+    std::vector<uint32_t> owners;
+    std::vector<uint32_t> ownedRows;
+    std::vector<uint32_t> remaining[IMPACT_COUNT];
+    size_t next[IMPACT_COUNT] = {};
+
+    while (true)
+    {
+        // the oldest bug at the front of the impact levels
+        size_t impact(IMPACT_COUNT);
+        for (size_t i(0); i < IMPACT_COUNT; ++i)
+        {
+            if (next[i] < rows[i].size()
+                && (impact == IMPACT_COUNT || bugs.key(rows[i][next[i]]) < bugs.key(rows[impact][next[impact]])))
+            {
+                impact = i;
+            }
+        }
+        if (impact == IMPACT_COUNT)
+        {
+            break;
+        }
+        uint32_t row = rows[impact][next[impact]++];
+
+        // drop entries pushed before their developer took another bug;
+        // a full developer has no current entry
+        MinHeap<DeveloperLoad> &heap = heaps[impact];
+        while (!heap.empty() && heap.findMinimum()->taken != taken[heap.findMinimum()->developer])
+        {
+            heap.popMinimum();
+        }
+        if (heap.empty())
+        {
+            remaining[impact].push_back(row);
+            continue;
+        }
+
+        uint32_t developer = heap.popMinimum().developer;
+        owners.push_back(developer);
+        ownedRows.push_back(row);
+        loads[developer] += weights[impact];
+        --room[developer];
+        --impactRoom[developer * IMPACT_COUNT + impact];
+        ++taken[developer];
+
+        for (size_t i(0); room[developer] > 0 && i < IMPACT_COUNT; ++i)
+        {
+            if (impactRoom[developer * IMPACT_COUNT + i] > 0)
+            {
+                heaps[i].push(DeveloperLoad{ loads[developer], developer, taken[developer] });
+            }
+        }
+    }
+
+    // group the assigned rows by developer, keeping each developer's in order
+    layout.ends.assign(count, 0);
+    size_t end(0);
+    for (size_t i(0); i < count; ++i)
+    {
+        end += taken[i];
+        layout.ends[i] = end;
+    }
+
+    std::vector<size_t> fill(count);
+    for (size_t i(0); i < count; ++i)
+    {
+        fill[i] = layout.ends[i] - taken[i];
+    }
+    layout.assigned.resize(ownedRows.size());
+    for (size_t n(0); n < ownedRows.size(); ++n)
+    {
+        layout.assigned[fill[owners[n]]++] = ownedRows[n];
+    }
+
+    layout.remaining.clear();
+    for (size_t impact(0); impact < IMPACT_COUNT; ++impact)
+    {
+        layout.remaining.insert(layout.remaining.end(), remaining[impact].begin(), remaining[impact].end());
+    }
+}
+
+#endif
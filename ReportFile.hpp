@@ -0,0 +1,317 @@
+#ifndef REPORT_FILE_HPP
+#define REPORT_FILE_HPP
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "BugColumns.hpp"
+#include "DeveloperRoster.hpp"
+#include "Parallel.hpp"
+#include "Report.hpp"
+
+
+// Writes the report of a laid out columnar table straight into a file from
+// several threads, byte for byte the same as writeReport would.
+//
+// Once the assignment is decided every part of the report can be sized
+// without writing it, so the report is cut into units (a developer, or a
+// slice of the bugs of one) and:
+//   1. each unit's size is worked out, in parallel
+//   2. a prefix sum gives every unit its offset in the file
+//   3. the file is sized up front with ftruncate
+//   4. workers format runs of units into their own buffers and pwrite them
+//      at their offsets, so nothing is shared but the file
+// Output that isn't a regular file, such as a pipe, is written in order by
+// one thread instead.
+class ReportFile
+{
+    private:
+
+    static constexpr size_t UNIT_BUGS = 4096;           // most bugs in one unit
+    static constexpr size_t TASK_BYTES = size_t(1) << 20; // bytes a worker formats per write
+    static constexpr size_t REMAINING = SIZE_MAX;       // developer of the units under <remaining>
+
+    static constexpr std::string_view HEADER = "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<report>\n";
+    static constexpr std::string_view DEVELOPER_OPEN = "<developer id=\"";
+    static constexpr std::string_view DEVELOPER_OPEN_END = "\">\n";
+    static constexpr std::string_view DEVELOPER_CLOSE = "</developer>\n";
+    static constexpr std::string_view REMAINING_OPEN = "<remaining>\n";
+    static constexpr std::string_view FOOTER = "</remaining>\n</report>";
+    static constexpr std::string_view BUG_OPEN = "<bug id=\"";
+    static constexpr std::string_view BUG_DESCRIPTION = "\">\n<description>";
+    static constexpr std::string_view BUG_IMPACT = "</description>\n<impact>";
+    static constexpr std::string_view BUG_CREATED = "</impact>\n<created>";
+    static constexpr std::string_view BUG_CLOSE = "</created>\n</bug>\n";
+
+    // Rows rows[begin] up to rows[end] of a developer, or of the remaining
+    // bugs, with the opening tag if first and the closing tag if last
+    struct Unit
+    {
+        size_t developer;
+        size_t begin;
+        size_t end;
+        bool first;
+        bool last;
+    };
+
+    DeveloperRoster const &developers_;
+    BugColumns const &bugs_;
+    ReportLayout const &layout_;
+    std::vector<Unit> units_;
+    std::vector<uint64_t> offsets_;     // offset of each unit in the file, then the file size
+    uint64_t bytes_;
+
+
+    // Return the rows a unit's bugs come from
+    std::vector<uint32_t> const &rows(Unit const &unit) const
+    {
+        return unit.developer == REMAINING ? layout_.remaining : layout_.assigned;
+    }
+
+    // Split developer's rows, or the remaining rows, into units
+    void addUnits(size_t developer, size_t begin, size_t end)
+    {
+        size_t from(begin);
+        do
+        {
+            size_t to = end - from > UNIT_BUGS ? from + UNIT_BUGS : end;
+            units_.push_back(Unit{ developer, from, to, from == begin, to == end });
+            from = to;
+        } while (from < end);
+    }
+
+    // Return the number of bytes writeBug writes for a bug
+    static size_t bugSize(BugColumns::Record const &bug)
+    {
+        size_t idSize = bug.id.canonical() ? size_t(BugId::WIDTH) : bug.id.str().size();
+        return BUG_OPEN.size() + idSize + BUG_DESCRIPTION.size() + bug.description.size() + BUG_IMPACT.size()
+             + bug.impact.size() + BUG_CREATED.size() + bug.date.size() + BUG_CLOSE.size();
+    }
+
+    // Return the number of bytes of a unit
+    uint64_t unitSize(Unit const &unit) const
+    {
+        uint64_t size(0);
+        if (unit.developer == REMAINING)
+        {
+            size += (unit.first ? REMAINING_OPEN.size() : 0) + (unit.last ? FOOTER.size() : 0);
+        }
+        else
+        {
+            size += unit.first ? DEVELOPER_OPEN.size() + developers_.id(unit.developer).size()
+                                 + DEVELOPER_OPEN_END.size() : 0;
+            size += unit.last ? DEVELOPER_CLOSE.size() : 0;
+        }
+
+        std::vector<uint32_t> const &unitRows = rows(unit);
+        for (size_t n(unit.begin); n < unit.end; ++n)
+        {
+            size += bugSize(bugs_.at(unitRows[n]));
+        }
+        return size;
+    }
+
+    // Append a bug's element to out
+    static void appendBug(std::string &out, BugColumns::Record const &bug)
+    {
+        out.append(BUG_OPEN);
+        if (bug.id.canonical())
+        {
+            char text[BugId::WIDTH];
+            bug.id.formatHex(text);
+            out.append(text, BugId::WIDTH);
+        }
+        else
+        {
+            out.append(bug.id.str());
+        }
+        out.append(BUG_DESCRIPTION);
+        out.append(bug.description);
+        out.append(BUG_IMPACT);
+        out.append(bug.impact);
+        out.append(BUG_CREATED);
+        out.append(bug.date);
+        out.append(BUG_CLOSE);
+    }
+
+    // Append a unit's text to out
+    void appendUnit(std::string &out, Unit const &unit) const
+    {
+        if (unit.first)
+        {
+            if (unit.developer == REMAINING)
+            {
+                out.append(REMAINING_OPEN);
+            }
+            else
+            {
+                out.append(DEVELOPER_OPEN);
+                out.append(developers_.id(unit.developer));
+                out.append(DEVELOPER_OPEN_END);
+            }
+        }
+
+        std::vector<uint32_t> const &unitRows = rows(unit);
+        for (size_t n(unit.begin); n < unit.end; ++n)
+        {
+            appendBug(out, bugs_.at(unitRows[n]));
+        }
+
+        if (unit.last)
+        {
+            out.append(unit.developer == REMAINING ? FOOTER : DEVELOPER_CLOSE);
+        }
+    }
+
+    // Write all of text at offset, or at the current position if offset is negative.
+    // Return false if the write fails.
+    static bool writeAll(int fd, std::string const &text, off_t offset)
+    {
+        size_t done(0);
+        while (done < text.size())
+        {
+            ssize_t written = offset < 0 ? ::write(fd, text.data() + done, text.size() - done)
+                                         : ::pwrite(fd, text.data() + done, text.size() - done,
+                                                    offset + static_cast<off_t>(done));
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                return false;
+            }
+            done += static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    // Write every unit in order from one thread
+    bool writeInOrder(int fd)
+    {
+        std::string buffer(HEADER);
+        for (Unit const &unit : units_)
+        {
+            appendUnit(buffer, unit);
+            if (buffer.size() >= TASK_BYTES)
+            {
+                if (!writeAll(fd, buffer, -1))
+                {
+                    return false;
+                }
+                bytes_ += buffer.size();
+                buffer.clear();
+            }
+        }
+        bytes_ += buffer.size();
+        return writeAll(fd, buffer, -1);
+    }
+
+    // Size the units, size the file, then write runs of units on threads
+    bool writeInParallel(int fd, unsigned threads)
+    {
+        offsets_.assign(units_.size() + 1, 0);
+        forEachOnThreads(units_.size(), threads, [&](size_t i, unsigned) {
+            offsets_[i + 1] = unitSize(units_[i]);
+        });
+
+        offsets_[0] = HEADER.size();
+        for (size_t i(1); i < offsets_.size(); ++i)
+        {
+            offsets_[i] += offsets_[i - 1];
+        }
+
+        if (::ftruncate(fd, static_cast<off_t>(offsets_.back())) != 0)
+        {
+            return false;
+        }
+        bytes_ = offsets_.back();
+
+        // runs of consecutive units of about TASK_BYTES each
+        std::vector<size_t> taskEnds;
+        for (size_t i(0), start(0); i < units_.size(); ++i)
+        {
+            if (offsets_[i + 1] - offsets_[start] >= TASK_BYTES || i + 1 == units_.size())
+            {
+                taskEnds.push_back(i + 1);
+                start = i + 1;
+            }
+        }
+
+        std::vector<std::string> buffers(threads);
+        std::atomic<bool> failed(!writeAll(fd, std::string(HEADER), 0));
+        forEachOnThreads(taskEnds.size(), threads, [&](size_t task, unsigned worker) {
+            size_t begin = task == 0 ? 0 : taskEnds[task - 1];
+            std::string &buffer = buffers[worker];
+            buffer.clear();
+            for (size_t i(begin); i < taskEnds[task]; ++i)
+            {
+                appendUnit(buffer, units_[i]);
+            }
+
+            if (buffer.size() != offsets_[taskEnds[task]] - offsets_[begin])
+            {
+                std::cerr<<"ReportFile::write - Formatted report doesn't match its sizes\n";
+                failed = true;
+                return;
+            }
+            if (!writeAll(fd, buffer, static_cast<off_t>(offsets_[begin])))
+            {
+                failed = true;
+            }
+        });
+
+        return !failed;
+    }
+
+    public:
+
+    // Constructor; developers, bugs and layout must outlive the writer
+    ReportFile(DeveloperRoster const &developers, BugColumns const &bugs, ReportLayout const &layout)
+        : developers_(developers), bugs_(bugs), layout_(layout), bytes_(0)
+    {
+        for (size_t i(0); i < developers.size(); ++i)
+        {
+            addUnits(i, layout.begin(i), layout.end(i));
+        }
+        addUnits(REMAINING, 0, layout.remaining.size());
+    }
+
+    // Write the report to path using up to threads threads.
+    // Return false (after printing why) if it can't be written.
+    bool write(std::string const &path, unsigned threads)
+    {
+        int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+        if (fd < 0)
+        {
+            std::cerr<<"Can't open "<<path<<"!"<<std::endl;
+            return false;
+        }
+
+        struct stat status;
+        bool regular = ::fstat(fd, &status) == 0 && S_ISREG(status.st_mode);
+        bool written = regular && threads > 1 ? writeInParallel(fd, threads) : writeInOrder(fd);
+        if (::close(fd) != 0 || !written)
+        {
+            std::cerr<<"Can't write "<<path<<"!"<<std::endl;
+            return false;
+        }
+
+        return true;
+    }
+
+    // Return the number of bytes of the report written so far
+    uint64_t bytes() const
+    {
+        return bytes_;
+    }
+};
+
+#endif
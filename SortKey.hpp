@@ -0,0 +1,21 @@
+#ifndef SORT_KEY_HPP
+#define SORT_KEY_HPP
+
+
+// Compact sort key for the ordered containers that keep keys apart from their
+// elements (BTree, FrozenTree). By default an element is its own key;
+// specialise this for payloads that have a cheaper key.
+// type must be default constructible and ordered by operator <, in the same
+// order as the elements themselves.
+template <typename T>
+struct SortKey
+{
+    typedef T type;
+
+    static T const &get(T const &data)
+    {
+        return data;
+    }
+};
+
+#endif
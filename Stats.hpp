@@ -0,0 +1,166 @@
+#ifndef STATS_HPP
+#define STATS_HPP
+
+// Pipeline instrumentation: monotonic stage timers and counters, reported as
+// a JSON block on stderr at the end of a run.
+//
+// Only compiled in with -DPEST_CONTROL_STATS. Without it every STATS_* macro
+// expands to nothing, so instrumented code costs nothing in normal builds.
+// With it, allocations are counted through the AllocTracker.hpp hooks, so
+// this header must only be included from one translation unit.
+
+#ifdef PEST_CONTROL_STATS
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <streambuf>
+#include "AllocTracker.hpp"
+
+namespace Stats
+{
+    enum Stage
+    {
+        STAGE_PARSE,
+        STAGE_BUILD,
+        STAGE_WRITE,
+        STAGE_COUNT
+    };
+
+    enum Counter
+    {
+        BUGS_PARSED,
+        BUGS_HIGH,
+        BUGS_MEDIUM,
+        BUGS_LOW,
+        DUPLICATES_DROPPED,
+        DESCRIPTIONS_STORED,
+        BYTES_WRITTEN,
+        ALLOCATIONS,
+        COUNTER_COUNT
+    };
+
+    static char const * const STAGE_NAMES[STAGE_COUNT] = { "parse", "build", "write" };
+    static char const * const COUNTER_NAMES[COUNTER_COUNT] = {
+        "bugs_parsed", "bugs_high", "bugs_medium", "bugs_low", "duplicates_dropped", "descriptions_stored",
+        "bytes_written", "allocations" };
+
+    // Totals are atomic so batch workers can add to them concurrently.
+    // Stage times from several threads are summed. ALLOCATIONS is read
+    // from the allocation hooks rather than counted here.
+    inline std::atomic<uint64_t> stageNanoseconds[STAGE_COUNT];
+    inline std::atomic<uint64_t> counters[COUNTER_COUNT];
+
+    // Add the time from construction until stop() or destruction to a stage
+    class ScopedTimer
+    {
+        private:
+        Stage stage_;
+        bool running_;
+        std::chrono::steady_clock::time_point start_;
+
+        public:
+
+        ScopedTimer(Stage stage) : stage_(stage), running_(true), start_(std::chrono::steady_clock::now()){}
+
+        // Stop timing early, for stages that don't end with a scope
+        void stop()
+        {
+            if (running_)
+            {
+                auto elapsed = std::chrono::steady_clock::now() - start_;
+                stageNanoseconds[stage_].fetch_add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(), std::memory_order_relaxed);
+                running_ = false;
+            }
+        }
+
+        ~ScopedTimer()
+        {
+            stop();
+        }
+    };
+
+    // Unbuffered pass-through stream buffer that counts the bytes written through it
+    class CountingStreamBuffer : public std::streambuf
+    {
+        private:
+        std::streambuf* target_;
+        uint64_t count_;
+
+        protected:
+
+        int overflow(int c) override
+        {
+            if (c != traits_type::eof())
+            {
+                ++count_;
+                return target_->sputc(static_cast<char>(c));
+            }
+            return traits_type::not_eof(c);
+        }
+
+        std::streamsize xsputn(char const *s, std::streamsize n) override
+        {
+            std::streamsize written = target_->sputn(s, n);
+            count_ += static_cast<uint64_t>(written);
+            return written;
+        }
+
+        int sync() override
+        {
+            return target_->pubsync();
+        }
+
+        public:
+
+        CountingStreamBuffer(std::streambuf* target) : target_(target), count_(0){}
+
+        // Add the bytes written so far to BYTES_WRITTEN
+        ~CountingStreamBuffer()
+        {
+            counters[BYTES_WRITTEN].fetch_add(count_, std::memory_order_relaxed);
+        }
+    };
+
+    // Write every stage time (in milliseconds) and counter as one JSON object
+    inline void writeJson(std::ostream &out)
+    {
+        out<<"{\"stages_ms\":{";
+        for (size_t stage(0); stage < STAGE_COUNT; ++stage)
+        {
+            out<<(stage ? "," : "")<<"\""<<STAGE_NAMES[stage]<<"\":"<<stageNanoseconds[stage].load() / 1e6;
+        }
+        out<<"},\"counters\":{";
+        for (size_t counter(0); counter < COUNTER_COUNT; ++counter)
+        {
+            uint64_t value = counter == ALLOCATIONS ? AllocTracker::total.allocations.load() : counters[counter].load();
+            out<<(counter ? "," : "")<<"\""<<COUNTER_NAMES[counter]<<"\":"<<value;
+        }
+        out<<"}}"<<std::endl;
+    }
+}
+
+#define STATS_CONCAT_(a, b) a##b
+#define STATS_CONCAT(a, b) STATS_CONCAT_(a, b)
+#define STATS_TIMER(stage) Stats::ScopedTimer STATS_CONCAT(statsTimer, __LINE__)(Stats::stage)
+#define STATS_TIMER_START(name, stage) Stats::ScopedTimer name(Stats::stage)
+#define STATS_TIMER_STOP(name) name.stop()
+#define STATS_ADD(counter, amount) Stats::counters[Stats::counter].fetch_add((amount), std::memory_order_relaxed)
+#define STATS_REPORT(out) Stats::writeJson(out)
+#define STATS_COUNTED_STREAM(name, out) \
+    Stats::CountingStreamBuffer STATS_CONCAT(name, Buffer)((out).rdbuf()); std::ostream name(&STATS_CONCAT(name, Buffer))
+
+#else
+
+#define STATS_TIMER(stage)
+#define STATS_TIMER_START(name, stage)
+#define STATS_TIMER_STOP(name)
+#define STATS_ADD(counter, amount)
+#define STATS_REPORT(out)
+#define STATS_COUNTED_STREAM(name, out) std::ostream &name = (out)
+
+#endif
+
+#endif
@@ -0,0 +1,164 @@
+#ifndef STRING_POOL_HPP
+#define STRING_POOL_HPP
+
+#include <cstdint>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+
+// Arena of immutable strings addressed by 32-bit handles.
+//
+// Text is copied into large chunks that are never reallocated, so adding a
+// string is a bump of the current chunk and views returned by get() stay
+// valid until the pool is cleared. An interning pool is hash-consed: adding
+// text it already holds returns the existing handle, so each distinct text is
+// stored once and two handles are equal exactly when their texts are.
+class StringPool
+{
+    private:
+
+    static constexpr size_t CHUNK_SIZE = size_t(1) << 20;
+    static constexpr uint32_t EMPTY_SLOT = UINT32_MAX;
+
+    struct Entry
+    {
+        uint32_t chunk;
+        uint32_t offset;
+        uint32_t length;
+        uint32_t hash;      // only set when interning
+    };
+
+    std::vector<std::vector<char>> chunks_;
+    std::vector<Entry> entries_;
+    std::vector<uint32_t> slots_;   // open addressing table of handles, only used when interning
+    size_t bytes_;
+    bool intern_;
+
+
+    // FNV-1a
+    static uint32_t hash(std::string_view text)
+    {
+        uint32_t h(2166136261u);
+        for (char c : text)
+        {
+            h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return h;
+    }
+
+    // Copy text to the end of the arena and return its handle
+    uint32_t store(std::string_view text, uint32_t textHash)
+    {
+        if (text.size() > UINT32_MAX || entries_.size() >= EMPTY_SLOT)
+        {
+            throw std::length_error("StringPool::add - Pool is full");
+        }
+
+        if (chunks_.empty() || chunks_.back().capacity() - chunks_.back().size() < text.size())
+        {
+            chunks_.emplace_back();
+            chunks_.back().reserve(text.size() > CHUNK_SIZE ? text.size() : CHUNK_SIZE);
+        }
+
+        std::vector<char> &chunk = chunks_.back();
+        entries_.push_back(Entry{ static_cast<uint32_t>(chunks_.size() - 1), static_cast<uint32_t>(chunk.size()),
+                                  static_cast<uint32_t>(text.size()), textHash });
+        chunk.insert(chunk.end(), text.begin(), text.end());
+        bytes_ += text.size();
+        return static_cast<uint32_t>(entries_.size() - 1);
+    }
+
+    // Double the slot table once it is three quarters full
+    void grow()
+    {
+        if (4 * (entries_.size() + 1) <= 3 * slots_.size())
+        {
+            return;
+        }
+
+        std::vector<uint32_t> slots(slots_.empty() ? 1024 : 2 * slots_.size(), EMPTY_SLOT);
+        size_t mask = slots.size() - 1;
+        for (uint32_t handle(0); handle < entries_.size(); ++handle)
+        {
+            size_t slot = entries_[handle].hash & mask;
+            while (slots[slot] != EMPTY_SLOT)
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = handle;
+        }
+        slots_.swap(slots);
+    }
+
+
+    public:
+
+    // Constructor; intern selects hash-consing
+    explicit StringPool(bool intern = false) : bytes_(0), intern_(intern){}
+
+    // Return true if the pool stores each distinct text once, otherwise false
+    bool interning() const
+    {
+        return intern_;
+    }
+
+    // Return the number of strings stored
+    size_t size() const
+    {
+        return entries_.size();
+    }
+
+    // Return the number of text bytes stored
+    size_t bytes() const
+    {
+        return bytes_;
+    }
+
+    // Store text and return its handle. An interning pool returns the
+    // handle already given out for the same text, if there is one.
+    uint32_t add(std::string_view text)
+    {
+        if (!intern_)
+        {
+            return store(text, 0);
+        }
+
+        uint32_t textHash = hash(text);
+        grow();
+        size_t mask = slots_.size() - 1;
+        size_t slot = textHash & mask;
+        while (slots_[slot] != EMPTY_SLOT)
+        {
+            uint32_t handle = slots_[slot];
+            if (entries_[handle].hash == textHash && get(handle) == text)
+            {
+                return handle;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        uint32_t handle = store(text, textHash);
+        slots_[slot] = handle;
+        return handle;
+    }
+
+    // Return the text of a handle
+    std::string_view get(uint32_t handle) const
+    {
+        Entry const &entry = entries_[handle];
+        return std::string_view(chunks_[entry.chunk].data() + entry.offset, entry.length);
+    }
+
+    // Remove every string; handles given out so far become invalid
+    void clear()
+    {
+        chunks_.clear();
+        entries_.clear();
+        slots_.clear();
+        bytes_ = 0;
+    }
+
+};
+
+#endif
@@ -0,0 +1,36 @@
+#!/bin/sh
+# Run every regression input through each container and compare the reports
+# with the expected ones.
+#
+# Usage: regression/run.sh [path/to/Pest-Control]
+# Build first with: g++ -std=c++17 -O2 -pthread Pest-Control.cpp -o Pest-Control
+
+dir=$(cd "$(dirname "$0")" && pwd)
+program=${1:-"$dir/../Pest-Control"}
+report=$(mktemp)
+trap 'rm -f "$report"' EXIT
+
+failures=0
+
+# check <name> <input> <expected> <options...>
+check() {
+    name=$1
+    input=$2
+    expected=$3
+    shift 3
+    if "$program" -i "$input" -o "$report" "$@" >/dev/null && cmp -s "$report" "$expected"; then
+        echo "ok   $name"
+    else
+        echo "FAIL $name"
+        failures=$((failures + 1))
+    fi
+}
+
+for container in bst btree heap columns; do
+    check "overlong-dates --container $container" "$dir/overlong-dates.xml" "$dir/overlong-dates-report.xml" \
+          -d 2 --container "$container"
+done
+check "overlong-dates --container columns -j 3" "$dir/overlong-dates.xml" "$dir/overlong-dates-report.xml" \
+      -d 2 --container columns -j 3
+
+[ "$failures" -eq 0 ]